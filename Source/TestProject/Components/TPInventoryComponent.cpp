@@ -2,35 +2,188 @@
 
 
 #include "Components/TPInventoryComponent.h"
+#include "Async/Async.h"
+#include "Items/TPPickupSubsystem.h"
 
 
 UTPInventoryComponent::UTPInventoryComponent()
 {
-	PrimaryComponentTick.bCanEverTick = false;
-
-	// ...
+	// Ticks only to broadcast coalesced changes, after everything that could add items this frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
 }
 
 bool UTPInventoryComponent::TryToAddItem(const FInventoryData& Data)
 {
-	if (Data.Score < 0) return false;
+	const int32 TypeIndex = static_cast<int32>(Data.Type);
+	checkSlow(TypeIndex < InventoryItemTypeCount);
+
+	if (Data.Score < 0 || !TryToReserve(TypeIndex, Data.Score)) return false;
+
+	NotifyInventoryChanged(Data.Score > 0 ? 1 << TypeIndex : 0);
+
+	return true;
+}
+
+bool UTPInventoryComponent::TryToAddItems(TConstArrayView<FInventoryData> Items, TArray<EInventoryAddResult>* OutResults)
+{
+	if (OutResults)
+	{
+		OutResults->SetNumUninitialized(Items.Num());
+	}
 
-	if (!Inventory.Contains(Data.Type))
+	// Running batch total per type, int64 so a batch of large scores can't wrap around the limit check
+	TStaticArray<int64, InventoryItemTypeCount> Pending{ InPlace, 0 };
+	bool bAllValid = true;
+	for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
 	{
-		Inventory.Add(Data.Type, 0);
+		const FInventoryData& Data = Items[ItemIndex];
+		const int32 TypeIndex = static_cast<int32>(Data.Type);
+		checkSlow(TypeIndex < InventoryItemTypeCount);
+
+		EInventoryAddResult Result = EInventoryAddResult::Added;
+		if (Data.Score < 0)
+		{
+			Result = EInventoryAddResult::NegativeScore;
+		}
+		else if (Pending[TypeIndex] + Data.Score > CachedInventoryLimits[TypeIndex] - Inventory[TypeIndex].load(std::memory_order_relaxed))
+		{
+			Result = EInventoryAddResult::OverLimit;
+		}
+		else
+		{
+			Pending[TypeIndex] += Data.Score;
+		}
+
+		bAllValid &= Result == EInventoryAddResult::Added;
+		if (OutResults)
+		{
+			(*OutResults)[ItemIndex] = Result;
+		}
 	}
 
-	const auto NextScore = Inventory[Data.Type] + Data.Score;
-	if (NextScore > InventoryLimits[Data.Type]) return false;
+	// Pending totals passed the check above so they fit int32. In concurrent mode other threads may have
+	// added items since, every type is reserved again and the batch is rolled back if one doesn't fit anymore.
+	int32 ChangedTypesMask = 0;
+	for (int32 TypeIndex = 0; bAllValid && TypeIndex < InventoryItemTypeCount; ++TypeIndex)
+	{
+		if (Pending[TypeIndex] == 0) continue;
+
+		if (TryToReserve(TypeIndex, static_cast<int32>(Pending[TypeIndex])))
+		{
+			ChangedTypesMask |= 1 << TypeIndex;
+			continue;
+		}
 
-	Inventory[Data.Type] = NextScore;
+		bAllValid = false;
+		for (int32 ReservedIndex = 0; ReservedIndex < TypeIndex; ++ReservedIndex)
+		{
+			Inventory[ReservedIndex].fetch_sub(static_cast<int32>(Pending[ReservedIndex]), std::memory_order_relaxed);
+		}
+		if (OutResults)
+		{
+			for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+			{
+				(*OutResults)[ItemIndex] = static_cast<int32>(Items[ItemIndex].Type) == TypeIndex ? EInventoryAddResult::OverLimit : EInventoryAddResult::Added;
+			}
+		}
+	}
+
+	if (!bAllValid)
+	{
+		if (OutResults)
+		{
+			for (EInventoryAddResult& Result : *OutResults)
+			{
+				Result = Result == EInventoryAddResult::Added ? EInventoryAddResult::NotCommitted : Result;
+			}
+		}
+		return false;
+	}
+
+	NotifyInventoryChanged(ChangedTypesMask);
 
 	return true;
 }
 
 int32 UTPInventoryComponent::GetInventoryAmountByType(EInventoryItemType Type) const
 {
-	return Inventory.Contains(Type) ? Inventory[Type] : 0;
+	return Inventory[static_cast<int32>(Type)].load(std::memory_order_relaxed);
+}
+
+bool UTPInventoryComponent::TryToReserve(int32 TypeIndex, int32 Score)
+{
+	const int32 Limit = CachedInventoryLimits[TypeIndex];
+	std::atomic<int32>& Amount = Inventory[TypeIndex];
+
+	// Both sides of the limit checks are non-negative, comparing the remaining space can't overflow
+	int32 Current = Amount.load(std::memory_order_relaxed);
+	if (!bConcurrentAdds)
+	{
+		if (Score > Limit - Current) return false;
+		Amount.store(Current + Score, std::memory_order_relaxed);
+		return true;
+	}
+
+	do
+	{
+		if (Score > Limit - Current) return false;
+	}
+	while (!Amount.compare_exchange_weak(Current, Current + Score, std::memory_order_relaxed));
+	return true;
+}
+
+void UTPInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushInventoryChanges();
+}
+
+void UTPInventoryComponent::FlushInventoryChanges()
+{
+	check(IsInGameThread());
+
+	// Disabled before the mask is taken, a change that comes in between re-enables the tick
+	SetComponentTickEnabled(false);
+
+	// Listeners may add items again, those land in the next broadcast
+	const int32 ChangedTypesMask = DirtyTypesMask.exchange(0);
+	if (ChangedTypesMask == 0) return;
+
+	OnInventoryChanged.Broadcast(ChangedTypesMask);
+}
+
+void UTPInventoryComponent::NotifyInventoryChanged(int32 ChangedTypesMask)
+{
+	if (ChangedTypesMask == 0) return;
+
+	// Only the first change since the last broadcast enables the tick
+	if (DirtyTypesMask.fetch_or(ChangedTypesMask) != 0) return;
+
+	if (IsInGameThread())
+	{
+		SetComponentTickEnabled(true);
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UTPInventoryComponent>(this)]()
+		{
+			if (WeakThis.IsValid() && WeakThis->GetDirtyTypesMask() != 0)
+			{
+				WeakThis->SetComponentTickEnabled(true);
+			}
+		});
+}
+
+void UTPInventoryComponent::CacheInventoryLimits()
+{
+	for (int32 TypeIndex = 0; TypeIndex < InventoryItemTypeCount; ++TypeIndex)
+	{
+		const int32* Limit = InventoryLimits.Find(static_cast<EInventoryItemType>(TypeIndex));
+		CachedInventoryLimits[TypeIndex] = Limit ? FMath::Max(*Limit, 0) : 0;
+	}
 }
 
 
@@ -40,6 +193,7 @@ void UTPInventoryComponent::BeginPlay()
 	Super::BeginPlay();
 
 	const auto InvEnum = StaticEnum<EInventoryItemType>();
+	checkf(InvEnum->NumEnums() - 1 == InventoryItemTypeCount, TEXT("InventoryItemTypeCount doesn't match EInventoryItemType"));
 	for (int32 i = 0; i < InvEnum->NumEnums() - 1; ++i)
 	{
 		const EInventoryItemType EnumElem = static_cast<EInventoryItemType>(i);
@@ -47,4 +201,21 @@ void UTPInventoryComponent::BeginPlay()
 		const bool LimitCheckCond = InventoryLimits.Contains(EnumElem) && InventoryLimits[EnumElem] >= 0 ;
 		checkf(LimitCheckCond, TEXT("Limits for %s doesn't exist or less then zero"), *EnumElemName)
 	}
+
+	CacheInventoryLimits();
+
+	if (UTPPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UTPPickupSubsystem>())
+	{
+		PickupSubsystem->RegisterCollector(this);
+	}
+}
+
+void UTPInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTPPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UTPPickupSubsystem>())
+	{
+		PickupSubsystem->UnregisterCollector(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
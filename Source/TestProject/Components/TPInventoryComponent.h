@@ -4,9 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Containers/StaticArray.h"
+#include <atomic>
 #include "TestProject/TPTypes.h"
 #include "TPInventoryComponent.generated.h"
 
+// Bit 1 << EInventoryItemType is set for every type whose amount changed since the last broadcast
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryChanged, int32, ChangedTypesMask);
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class TESTPROJECT_API UTPInventoryComponent : public UActorComponent
@@ -17,7 +21,31 @@ public:
 	// Sets default values for this component's properties
 	UTPInventoryComponent();
 
+	/** Fires at most once per frame, after all gameplay ticked, with every type changed during the frame. */
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventoryChanged OnInventoryChanged;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Broadcasts pending changes now instead of at the end of the frame. */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void FlushInventoryChanges();
+
+	int32 GetDirtyTypesMask() const { return DirtyTypesMask.load(); }
+
+	/** Switch before worker threads start adding items, the game thread mode skips compare-and-swap. */
+	void SetConcurrentAdds(bool bEnabled) { bConcurrentAdds = bEnabled; }
+	bool IsConcurrentAdds() const { return bConcurrentAdds; }
+
+	/** Safe to call from worker threads in concurrent mode. */
 	bool TryToAddItem(const FInventoryData& Data);
+
+	/**
+	 * Adds all items or none: every limit is checked against the batch total in one pass before anything is committed.
+	 * OnInventoryChanged fires once for the whole batch. OutResults gets the result of every item when given.
+	 * In concurrent mode a batch racing other adds may be reserved and rolled back, amounts never exceed the limits.
+	 */
+	bool TryToAddItems(TConstArrayView<FInventoryData> Items, TArray<EInventoryAddResult>* OutResults = nullptr);
 	
 	UFUNCTION(BlueprintCallable)
 	int32 GetInventoryAmountByType(EInventoryItemType Type) const;
@@ -25,9 +53,28 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 		
+	// Lets AI and loot tasks add items from worker threads without locks, amounts are updated with compare-and-swap
+	UPROPERTY(EditDefaultsOnly, Category = "Inventory")
+	bool bConcurrentAdds{ false };
+
+	// Authoring format only, copied into array storage by CacheInventoryLimits
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TMap<EInventoryItemType, int32> InventoryLimits;
+
+	/** Resolves InventoryLimits once so lookups are array indexing, types without a limit can't be added. */
+	void CacheInventoryLimits();
+
 private:
-	TMap<EInventoryItemType, int32> Inventory;
+	/** Adds Score if it fits the limit, lock-free in concurrent mode. */
+	bool TryToReserve(int32 TypeIndex, int32 Score);
+	void NotifyInventoryChanged(int32 ChangedTypesMask);
+
+	// Indexed by EInventoryItemType
+	TStaticArray<std::atomic<int32>, InventoryItemTypeCount> Inventory{ InPlace, 0 };
+	TStaticArray<int32, InventoryItemTypeCount> CachedInventoryLimits{ InPlace, 0 };
+
+	// Types changed since the last broadcast, the component only ticks while this isn't zero
+	std::atomic<int32> DirtyTypesMask{ 0 };
 };
@@ -5,8 +5,6 @@
 
 using namespace TestProject;
 
-constexpr float ChargeAmount = 0.1f;
-
 Battery::Battery(float PercentIn)
 {
 	SetPercent(PercentIn);
@@ -29,8 +27,8 @@ float Battery::GetPercent() const
 
 FColor Battery::GetColor() const
 {
-	if (Percent > 0.8f) return FColor::Green;
-	if (Percent > 0.3f) return FColor::Yellow;
+	if (Percent > GreenThreshold) return FColor::Green;
+	if (Percent > YellowThreshold) return FColor::Yellow;
 	return FColor::Red;
 }
 
@@ -12,6 +12,11 @@ namespace TestProject
 	class TESTPROJECT_API Battery
 	{
 	public:
+		// Shared with TBatteryPool, which has to match these methods bit for bit
+		static constexpr float ChargeAmount = 0.1f;
+		static constexpr float GreenThreshold = 0.8f;
+		static constexpr float YellowThreshold = 0.3f;
+
 		Battery() = default;
 		explicit Battery(float PercentIn);
 
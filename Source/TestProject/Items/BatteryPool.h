@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Items/Battery.h"
+
+namespace TestProject
+{
+	/**
+	 * Many batteries as one contiguous array of percents, updated four at a time in SIMD registers.
+	 * Every operation gives bit-identical results to calling the Battery method on each battery.
+	 */
+	template<typename AllocatorType = FDefaultAllocator>
+	class TBatteryPool
+	{
+	public:
+		int32 Num() const { return Percents.Num(); }
+		void Reserve(int32 Number) { Percents.Reserve(Number); }
+		void Reset() { Percents.Reset(); }
+
+		int32 Add(float Percent) { return Percents.Add(FMath::Clamp(Percent, 0.0f, 1.0f)); }
+		int32 Add(const Battery& Item) { return Percents.Add(Item.GetPercent()); }
+
+		float GetPercent(int32 Index) const { return Percents[Index]; }
+		Battery GetBattery(int32 Index) const { return Battery(Percents[Index]); }
+		TConstArrayView<float> GetPercents() const { return Percents; }
+
+		void ChargeAll() { AddToAll(Battery::ChargeAmount); }
+		void DischargeAll() { AddToAll(-Battery::ChargeAmount); }
+
+		/** Adds a delta per battery, Deltas must have Num() elements. */
+		void ApplyDelta(TConstArrayView<float> Deltas)
+		{
+			check(Deltas.Num() == Percents.Num());
+
+			float* Data = Percents.GetData();
+			const int32 VectorEnd = Percents.Num() & ~3;
+			for (int32 Index = 0; Index < VectorEnd; Index += 4)
+			{
+				VectorStore(Clamp(VectorAdd(VectorLoad(Data + Index), VectorLoad(Deltas.GetData() + Index))), Data + Index);
+			}
+			for (int32 Index = VectorEnd; Index < Percents.Num(); ++Index)
+			{
+				Data[Index] = FMath::Clamp(Data[Index] + Deltas[Index], 0.0f, 1.0f);
+			}
+		}
+
+		/** Battery::GetColor of every battery as 0 red, 1 yellow or 2 green. */
+		void ClassifyColors(TArray<uint8>& OutColorIndices) const
+		{
+			OutColorIndices.SetNumUninitialized(Percents.Num());
+
+			const float* Data = Percents.GetData();
+			const VectorRegister4Float Green = VectorSetFloat1(Battery::GreenThreshold);
+			const VectorRegister4Float Yellow = VectorSetFloat1(Battery::YellowThreshold);
+			const int32 VectorEnd = Percents.Num() & ~3;
+			for (int32 Index = 0; Index < VectorEnd; Index += 4)
+			{
+				const VectorRegister4Float Value = VectorLoad(Data + Index);
+				const int32 GreenBits = VectorMaskBits(VectorCompareGT(Value, Green));
+				const int32 YellowBits = VectorMaskBits(VectorCompareGT(Value, Yellow));
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					OutColorIndices[Index + Lane] = static_cast<uint8>(((GreenBits >> Lane) & 1) + ((YellowBits >> Lane) & 1));
+				}
+			}
+			for (int32 Index = VectorEnd; Index < Percents.Num(); ++Index)
+			{
+				OutColorIndices[Index] = static_cast<uint8>((Data[Index] > Battery::GreenThreshold) + (Data[Index] > Battery::YellowThreshold));
+			}
+		}
+
+		static FColor GetColorByIndex(uint8 ColorIndex)
+		{
+			static const FColor Colors[] = { FColor::Red, FColor::Yellow, FColor::Green };
+			return Colors[ColorIndex];
+		}
+
+		/** Indices of batteries with percent at or below Threshold, e.g. the ones to recharge. */
+		void FindAtOrBelow(float Threshold, TArray<int32>& OutIndices) const
+		{
+			OutIndices.Reset();
+
+			const float* Data = Percents.GetData();
+			const VectorRegister4Float ThresholdVector = VectorSetFloat1(Threshold);
+			const int32 VectorEnd = Percents.Num() & ~3;
+			for (int32 Index = 0; Index < VectorEnd; Index += 4)
+			{
+				for (int32 Bits = VectorMaskBits(VectorCompareLE(VectorLoad(Data + Index), ThresholdVector)); Bits != 0; Bits &= Bits - 1)
+				{
+					OutIndices.Add(Index + FMath::CountTrailingZeros(static_cast<uint32>(Bits)));
+				}
+			}
+			for (int32 Index = VectorEnd; Index < Percents.Num(); ++Index)
+			{
+				if (Data[Index] <= Threshold)
+				{
+					OutIndices.Add(Index);
+				}
+			}
+		}
+
+	private:
+		// FMath::Clamp(X, 0, 1) lane-wise, X < 0 ? 0 : (X < 1 ? X : 1), so NaN and -0 behave the same way
+		static VectorRegister4Float Clamp(const VectorRegister4Float& Value)
+		{
+			const VectorRegister4Float Zero = VectorZeroFloat();
+			const VectorRegister4Float One = VectorOneFloat();
+			const VectorRegister4Float UpperClamped = VectorSelect(VectorCompareLT(Value, One), Value, One);
+			return VectorSelect(VectorCompareLT(Value, Zero), Zero, UpperClamped);
+		}
+
+		void AddToAll(float Delta)
+		{
+			float* Data = Percents.GetData();
+			const VectorRegister4Float DeltaVector = VectorSetFloat1(Delta);
+			const int32 VectorEnd = Percents.Num() & ~3;
+			for (int32 Index = 0; Index < VectorEnd; Index += 4)
+			{
+				VectorStore(Clamp(VectorAdd(VectorLoad(Data + Index), DeltaVector)), Data + Index);
+			}
+			for (int32 Index = VectorEnd; Index < Percents.Num(); ++Index)
+			{
+				Data[Index] = FMath::Clamp(Data[Index] + Delta, 0.0f, 1.0f);
+			}
+		}
+
+		TArray<float, AllocatorType> Percents;
+	};
+
+	using FBatteryPool = TBatteryPool<>;
+}
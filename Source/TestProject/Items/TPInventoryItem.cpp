@@ -2,8 +2,8 @@
 
 
 #include "Items/TPInventoryItem.h"
-#include "GameFramework/Pawn.h"
 #include "Components/SphereComponent.h"
+#include "Items/TPPickupSubsystem.h"
 #include "TestProject/Components/TPInventoryComponent.h"
 
 // Sets default values
@@ -15,24 +15,52 @@ ATPInventoryItem::ATPInventoryItem()
 	CollisionComponent = CreateDefaultSubobject<USphereComponent>("SphereComponent");
 	check(CollisionComponent);
 	CollisionComponent->InitSphereRadius(30.0f);
-	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	CollisionComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-	CollisionComponent->SetGenerateOverlapEvents(true);
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CollisionComponent->SetGenerateOverlapEvents(false);
 	SetRootComponent(CollisionComponent);
 }
 
-void ATPInventoryItem::NotifyActorBeginOverlap(AActor* OtherActor)
+bool ATPInventoryItem::TryToGiveTo(UTPInventoryComponent* InventoryComponent)
 {
-	Super::NotifyActorBeginOverlap(OtherActor);
+	if (!InventoryComponent || !InventoryComponent->TryToAddItem(InventoryData)) return false;
 
-	if (const auto Pawn = Cast<APawn>(OtherActor))
+	Destroy();
+	return true;
+}
+
+void ATPInventoryItem::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Blueprints saved with the old overlap setup would still pay for the broadphase
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CollisionComponent->SetGenerateOverlapEvents(false);
+
+	if (UTPPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UTPPickupSubsystem>())
+	{
+		PickupSubsystem->RegisterItem(this, CollisionComponent->GetScaledSphereRadius());
+
+		// Moved, attached and simulated items keep their grid cell in sync
+		CollisionComponent->TransformUpdated.AddUObject(this, &ATPInventoryItem::OnRootTransformUpdated);
+	}
+}
+
+void ATPInventoryItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CollisionComponent->TransformUpdated.RemoveAll(this);
+
+	if (UTPPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UTPPickupSubsystem>())
+	{
+		PickupSubsystem->UnregisterItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATPInventoryItem::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UTPPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UTPPickupSubsystem>())
 	{
-		if (const auto InvComp = Pawn->FindComponentByClass<UTPInventoryComponent>())
-		{
-			if (InvComp->TryToAddItem(InventoryData))
-			{
-				Destroy();
-			}
-		}
+		PickupSubsystem->UpdateItem(this);
 	}
 }
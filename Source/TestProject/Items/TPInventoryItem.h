@@ -8,6 +8,7 @@
 #include "TPInventoryItem.generated.h"
 
 class USphereComponent;
+class UTPInventoryComponent;
 
 UCLASS(Abstract)
 class TESTPROJECT_API ATPInventoryItem : public AActor
@@ -16,9 +17,17 @@ class TESTPROJECT_API ATPInventoryItem : public AActor
 	
 public:	
 	ATPInventoryItem();
-	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+
+	/** Adds the item to the inventory and destroys it if it fits. */
+	bool TryToGiveTo(UTPInventoryComponent* InventoryComponent);
 
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	// Pickup radius only, overlaps are resolved by UTPPickupSubsystem so the sphere has no collision
 	UPROPERTY(VisibleAnywhere)
 	USphereComponent* CollisionComponent;
 
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/TPPickupSubsystem.h"
+#include "Items/TPInventoryItem.h"
+#include "GameFramework/Pawn.h"
+#include "TestProject/Components/TPInventoryComponent.h"
+
+void UTPPickupSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdatePickups();
+}
+
+TStatId UTPPickupSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTPPickupSubsystem, STATGROUP_Tickables);
+}
+
+bool UTPPickupSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTPPickupSubsystem::RegisterItem(ATPInventoryItem* Item, float PickupRadius)
+{
+	if (!Item) return;
+
+	UnregisterItem(Item);
+
+	const FVector Location = Item->GetActorLocation();
+	const FIntVector Cell = GetCell(Location);
+	Cells.FindOrAdd(Cell).Add({ Item, Location, PickupRadius });
+	ItemCells.Add(Item, Cell);
+	MaxItemRadius = FMath::Max(MaxItemRadius, PickupRadius);
+}
+
+void UTPPickupSubsystem::UnregisterItem(ATPInventoryItem* Item)
+{
+	FIntVector Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+
+	RemoveFromCell(Cell, Item);
+}
+
+void UTPPickupSubsystem::UpdateItem(ATPInventoryItem* Item)
+{
+	FIntVector* ItemCell = ItemCells.Find(Item);
+	if (!ItemCell) return;
+
+	const FVector Location = Item->GetActorLocation();
+	const FIntVector Cell = GetCell(Location);
+	TArray<FGridItem>& CellItems = Cells.FindChecked(*ItemCell);
+	FGridItem* GridItem = CellItems.FindByPredicate([Item](const FGridItem& Other) { return Other.Item.Get() == Item; });
+	check(GridItem);
+
+	if (Cell == *ItemCell)
+	{
+		GridItem->Location = Location;
+		return;
+	}
+
+	const float Radius = GridItem->Radius;
+	RemoveFromCell(*ItemCell, Item);
+	Cells.FindOrAdd(Cell).Add({ Item, Location, Radius });
+	*ItemCell = Cell;
+}
+
+void UTPPickupSubsystem::RemoveFromCell(const FIntVector& Cell, const TWeakObjectPtr<ATPInventoryItem>& Item)
+{
+	TArray<FGridItem>& CellItems = Cells.FindChecked(Cell);
+	CellItems.RemoveAllSwap([&Item](const FGridItem& GridItem) { return GridItem.Item.HasSameIndexAndSerialNumber(Item); });
+	if (CellItems.IsEmpty())
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+void UTPPickupSubsystem::RemoveStaleItems()
+{
+	// Stale weak pointers all compare equal, so they are swept by iteration rather than looked up
+	for (auto It = ItemCells.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = Cells.CreateIterator(); It; ++It)
+	{
+		It->Value.RemoveAllSwap([](const FGridItem& GridItem) { return !GridItem.Item.IsValid(); });
+		if (It->Value.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UTPPickupSubsystem::RegisterCollector(UTPInventoryComponent* InventoryComponent)
+{
+	if (InventoryComponent && Cast<APawn>(InventoryComponent->GetOwner()))
+	{
+		Collectors.AddUnique(InventoryComponent);
+	}
+}
+
+void UTPPickupSubsystem::UnregisterCollector(UTPInventoryComponent* InventoryComponent)
+{
+	Collectors.RemoveAllSwap([InventoryComponent](const TWeakObjectPtr<UTPInventoryComponent>& Collector)
+		{
+			return !Collector.IsValid() || Collector.Get() == InventoryComponent;
+		});
+}
+
+void UTPPickupSubsystem::UpdatePickups()
+{
+	Collectors.RemoveAllSwap([](const TWeakObjectPtr<UTPInventoryComponent>& Collector) { return !Collector.IsValid(); });
+	if (ItemCells.IsEmpty()) return;
+
+	// Picked up items unregister themselves while being destroyed, so they are collected first
+	bool bHasStaleItems = false;
+	TArray<TWeakObjectPtr<ATPInventoryItem>, TInlineAllocator<8>> Overlapping;
+	for (const TWeakObjectPtr<UTPInventoryComponent>& WeakCollector : TArray<TWeakObjectPtr<UTPInventoryComponent>, TInlineAllocator<4>>(Collectors))
+	{
+		UTPInventoryComponent* InventoryComponent = WeakCollector.Get();
+		const APawn* Pawn = InventoryComponent ? Cast<APawn>(InventoryComponent->GetOwner()) : nullptr;
+		if (!Pawn) continue;
+
+		float PawnRadius = 0.0f;
+		float PawnHalfHeight = 0.0f;
+		Pawn->GetSimpleCollisionCylinder(PawnRadius, PawnHalfHeight);
+		const FVector PawnLocation = Pawn->GetActorLocation();
+
+		const FVector SearchExtent(PawnRadius + MaxItemRadius, PawnRadius + MaxItemRadius, PawnHalfHeight + MaxItemRadius);
+		const FIntVector MinCell = GetCell(PawnLocation - SearchExtent);
+		const FIntVector MaxCell = GetCell(PawnLocation + SearchExtent);
+
+		// Sphere against the pawn capsule: distance to the capsule's segment below the sum of the radii
+		const float SegmentHalfLength = FMath::Max(PawnHalfHeight - PawnRadius, 0.0f);
+
+		Overlapping.Reset();
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					const TArray<FGridItem>* CellItems = Cells.Find(FIntVector(X, Y, Z));
+					if (!CellItems) continue;
+
+					for (const FGridItem& GridItem : *CellItems)
+					{
+						if (!GridItem.Item.IsValid())
+						{
+							bHasStaleItems = true;
+							continue;
+						}
+
+						const FVector ClosestPoint(PawnLocation.X, PawnLocation.Y,
+							FMath::Clamp(GridItem.Location.Z, PawnLocation.Z - SegmentHalfLength, PawnLocation.Z + SegmentHalfLength));
+						if (FVector::DistSquared(GridItem.Location, ClosestPoint) <= FMath::Square(PawnRadius + GridItem.Radius))
+						{
+							Overlapping.Add(GridItem.Item);
+						}
+					}
+				}
+			}
+		}
+
+		for (const TWeakObjectPtr<ATPInventoryItem>& Item : Overlapping)
+		{
+			if (Item.IsValid())
+			{
+				Item->TryToGiveTo(InventoryComponent);
+			}
+		}
+	}
+
+	if (bHasStaleItems)
+	{
+		RemoveStaleItems();
+	}
+}
+
+FIntVector UTPPickupSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPPickupSubsystem.generated.h"
+
+class ATPInventoryItem;
+class UTPInventoryComponent;
+
+/**
+ * Picks up inventory items for every pawn with an inventory component, without physics overlaps.
+ * Items are bucketed into a uniform grid, each frame only the cells around the few collecting pawns are tested.
+ * Registered items call UpdateItem whenever their root moves, so the grid follows moved, attached or simulated items.
+ * Only weak pointers are kept, items or collectors destroyed without EndPlay are dropped on the next update.
+ */
+UCLASS()
+class TESTPROJECT_API UTPPickupSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr float CellSize = 200.0f;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterItem(ATPInventoryItem* Item, float PickupRadius);
+	void UnregisterItem(ATPInventoryItem* Item);
+
+	/** Moves a registered item to its current actor location. */
+	void UpdateItem(ATPInventoryItem* Item);
+
+	void RegisterCollector(UTPInventoryComponent* InventoryComponent);
+	void UnregisterCollector(UTPInventoryComponent* InventoryComponent);
+
+	/** Hands every item overlapping a collector's collision cylinder to its inventory, called every tick. */
+	void UpdatePickups();
+
+	int32 GetNumItems() const { return ItemCells.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FGridItem
+	{
+		TWeakObjectPtr<ATPInventoryItem> Item;
+		FVector Location;
+		float Radius;
+	};
+
+	FIntVector GetCell(const FVector& Location) const;
+	void RemoveFromCell(const FIntVector& Cell, const TWeakObjectPtr<ATPInventoryItem>& Item);
+	void RemoveStaleItems();
+
+	TMap<FIntVector, TArray<FGridItem>> Cells;
+	TMap<TWeakObjectPtr<ATPInventoryItem>, FIntVector> ItemCells;
+	TArray<TWeakObjectPtr<UTPInventoryComponent>> Collectors;
+
+	// Largest registered pickup radius, widens the cell range searched around a collector
+	float MaxItemRadius{ 0.0f };
+};
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Science/BigInteger.h"
+
+using namespace TestProject;
+
+namespace
+{
+	// Below this many limbs in the shorter operand schoolbook multiplication is faster
+	constexpr int32 KaratsubaThreshold = 48;
+
+	// Rows summed into schoolbook columns between carry passes
+	constexpr int32 CarryInterval = 16;
+
+	// Factors up to this count are multiplied into a single number one by one
+	constexpr uint32 ProductLeafSize = 16;
+}
+
+FBigUnsigned::FBigUnsigned(uint64 Value)
+{
+	while (Value > 0)
+	{
+		Limbs.Add(static_cast<uint32>(Value % Base));
+		Value /= Base;
+	}
+}
+
+FString FBigUnsigned::ToString() const
+{
+	if (IsZero()) return TEXT("0");
+
+	FString Result = FString::Printf(TEXT("%u"), Limbs.Last());
+	const int32 LeadingLength = Result.Len();
+	Result.GetCharArray().SetNumUninitialized(LeadingLength + (Limbs.Num() - 1) * DigitsPerLimb + 1);
+
+	TCHAR* Digits = Result.GetCharArray().GetData() + LeadingLength;
+	for (int32 LimbIndex = Limbs.Num() - 2; LimbIndex >= 0; --LimbIndex)
+	{
+		uint32 Limb = Limbs[LimbIndex];
+		for (int32 Digit = DigitsPerLimb - 1; Digit >= 0; --Digit)
+		{
+			Digits[Digit] = static_cast<TCHAR>(TEXT('0') + Limb % 10);
+			Limb /= 10;
+		}
+		Digits += DigitsPerLimb;
+	}
+	*Digits = TEXT('\0');
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::operator+(const FBigUnsigned& Rhs) const
+{
+	FBigUnsigned Result = *this;
+	Result.AddShifted(Rhs, 0);
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::operator-(const FBigUnsigned& Rhs) const
+{
+	check(Limbs.Num() >= Rhs.Limbs.Num());
+
+	FBigUnsigned Result = *this;
+	int64 Borrow = 0;
+	for (int32 Index = 0; Index < Result.Limbs.Num() && (Index < Rhs.Limbs.Num() || Borrow); ++Index)
+	{
+		int64 Difference = static_cast<int64>(Result.Limbs[Index]) - Borrow - (Index < Rhs.Limbs.Num() ? Rhs.Limbs[Index] : 0);
+		Borrow = Difference < 0 ? 1 : 0;
+		Result.Limbs[Index] = static_cast<uint32>(Difference + Borrow * Base);
+	}
+	check(Borrow == 0);
+
+	Result.Trim();
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::operator*(const FBigUnsigned& Rhs) const
+{
+	if (IsZero() || Rhs.IsZero()) return FBigUnsigned();
+	return FMath::Min(Limbs.Num(), Rhs.Limbs.Num()) < KaratsubaThreshold ? MultiplySchoolbook(*this, Rhs) : MultiplyKaratsuba(*this, Rhs);
+}
+
+FBigUnsigned FBigUnsigned::Fibonacci(uint32 N)
+{
+	FBigUnsigned A;                       // F(k)
+	FBigUnsigned B(1);                    // F(k+1)
+	for (int32 Bit = 31 - FMath::CountLeadingZeros(N); Bit >= 0; --Bit)
+	{
+		// F(2k) = F(k) * (2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2
+		FBigUnsigned C = A * (B + B - A);
+		FBigUnsigned D = A * A + B * B;
+		if ((N >> Bit) & 1)
+		{
+			B = C + D;
+			A = MoveTemp(D);
+		}
+		else
+		{
+			A = MoveTemp(C);
+			B = MoveTemp(D);
+		}
+	}
+	return A;
+}
+
+FBigUnsigned FBigUnsigned::Factorial(uint32 N)
+{
+	return N < 2 ? FBigUnsigned(1) : RangeProduct(2, N);
+}
+
+FBigUnsigned FBigUnsigned::FromLimbs(const uint32* Data, int32 Num)
+{
+	FBigUnsigned Result;
+	Result.Limbs.Append(Data, Num);
+	Result.Trim();
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::MultiplySchoolbook(const FBigUnsigned& Lhs, const FBigUnsigned& Rhs)
+{
+	const int32 LhsNum = Lhs.Limbs.Num();
+	const int32 RhsNum = Rhs.Limbs.Num();
+
+	// Columns are summed without carrying, limb products are below 10^18 so a column holds
+	// CarryInterval of them on top of a normalized limb before uint64 overflows
+	TArray<uint64> Columns;
+	Columns.SetNumZeroed(LhsNum + RhsNum);
+	const auto Normalize = [&Columns]()
+		{
+			uint64 Carry = 0;
+			for (uint64& Column : Columns)
+			{
+				const uint64 Current = Column + Carry;
+				Column = Current % Base;
+				Carry = Current / Base;
+			}
+		};
+
+	for (int32 i = 0; i < LhsNum; ++i)
+	{
+		const uint64 Multiplier = Lhs.Limbs[i];
+		uint64* Out = Columns.GetData() + i;
+		for (int32 j = 0; j < RhsNum; ++j)
+		{
+			Out[j] += Multiplier * Rhs.Limbs[j];
+		}
+		if ((i + 1) % CarryInterval == 0)
+		{
+			Normalize();
+		}
+	}
+	Normalize();
+
+	FBigUnsigned Result;
+	Result.Limbs.SetNumUninitialized(Columns.Num());
+	for (int32 Index = 0; Index < Columns.Num(); ++Index)
+	{
+		Result.Limbs[Index] = static_cast<uint32>(Columns[Index]);
+	}
+	Result.Trim();
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::MultiplyKaratsuba(const FBigUnsigned& Lhs, const FBigUnsigned& Rhs)
+{
+	// (A1 * Base^Half + A0) * (B1 * Base^Half + B0) = Z2 * Base^2Half + Z1 * Base^Half + Z0
+	const int32 Half = FMath::Max(Lhs.Limbs.Num(), Rhs.Limbs.Num()) / 2;
+	const auto Split = [Half](const FBigUnsigned& Value, FBigUnsigned& OutLow, FBigUnsigned& OutHigh)
+		{
+			const int32 LowNum = FMath::Min(Half, Value.Limbs.Num());
+			OutLow = FromLimbs(Value.Limbs.GetData(), LowNum);
+			OutHigh = FromLimbs(Value.Limbs.GetData() + LowNum, Value.Limbs.Num() - LowNum);
+		};
+
+	FBigUnsigned A0, A1, B0, B1;
+	Split(Lhs, A0, A1);
+	Split(Rhs, B0, B1);
+
+	const FBigUnsigned Z0 = A0 * B0;
+	const FBigUnsigned Z2 = A1 * B1;
+	const FBigUnsigned Z1 = (A0 + A1) * (B0 + B1) - Z0 - Z2;
+
+	FBigUnsigned Result = Z0;
+	Result.AddShifted(Z1, Half);
+	Result.AddShifted(Z2, 2 * Half);
+	return Result;
+}
+
+FBigUnsigned FBigUnsigned::RangeProduct(uint32 First, uint32 Last)
+{
+	if (Last - First < ProductLeafSize)
+	{
+		FBigUnsigned Result(First);
+		for (uint32 Factor = First + 1; Factor <= Last; ++Factor)
+		{
+			Result.MultiplySmall(Factor);
+		}
+		return Result;
+	}
+
+	const uint32 Middle = First + (Last - First) / 2;
+	return RangeProduct(First, Middle) * RangeProduct(Middle + 1, Last);
+}
+
+void FBigUnsigned::MultiplySmall(uint32 Value)
+{
+	uint64 Carry = 0;
+	for (uint32& Limb : Limbs)
+	{
+		const uint64 Current = static_cast<uint64>(Limb) * Value + Carry;
+		Limb = static_cast<uint32>(Current % Base);
+		Carry = Current / Base;
+	}
+	while (Carry > 0)
+	{
+		Limbs.Add(static_cast<uint32>(Carry % Base));
+		Carry /= Base;
+	}
+	Trim();
+}
+
+void FBigUnsigned::AddShifted(const FBigUnsigned& Value, int32 Shift)
+{
+	if (Value.IsZero()) return;
+
+	if (Limbs.Num() < Shift + Value.Limbs.Num())
+	{
+		Limbs.SetNumZeroed(Shift + Value.Limbs.Num());
+	}
+
+	uint32 Carry = 0;
+	int32 Index = Shift;
+	for (int32 ValueIndex = 0; ValueIndex < Value.Limbs.Num() || Carry; ++ValueIndex, ++Index)
+	{
+		if (Index == Limbs.Num())
+		{
+			Limbs.Add(0);
+		}
+		uint32 Sum = Limbs[Index] + Carry + (ValueIndex < Value.Limbs.Num() ? Value.Limbs[ValueIndex] : 0);
+		Carry = Sum >= Base ? 1 : 0;
+		Limbs[Index] = Sum - Carry * Base;
+	}
+}
+
+void FBigUnsigned::Trim()
+{
+	while (!Limbs.IsEmpty() && Limbs.Last() == 0)
+	{
+		Limbs.Pop(EAllowShrinking::No);
+	}
+}
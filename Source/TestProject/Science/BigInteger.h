@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace TestProject
+{
+	/**
+	 * Non-negative integer of any size for exact tooling values.
+	 * Stored as base 10^9 limbs, least significant first, so printing doesn't need divisions.
+	 * Large operands are multiplied with Karatsuba.
+	 */
+	class TESTPROJECT_API FBigUnsigned
+	{
+	public:
+		static constexpr uint32 Base = 1000000000;
+		static constexpr int32 DigitsPerLimb = 9;
+
+		FBigUnsigned() = default;
+		explicit FBigUnsigned(uint64 Value);
+
+		bool IsZero() const { return Limbs.IsEmpty(); }
+		int32 GetNumLimbs() const { return Limbs.Num(); }
+		FString ToString() const;
+
+		FBigUnsigned operator+(const FBigUnsigned& Rhs) const;
+		/** Rhs must not be greater than this. */
+		FBigUnsigned operator-(const FBigUnsigned& Rhs) const;
+		FBigUnsigned operator*(const FBigUnsigned& Rhs) const;
+		bool operator==(const FBigUnsigned& Rhs) const { return Limbs == Rhs.Limbs; }
+
+		/** Fast doubling, O(log N) multiplications. */
+		static FBigUnsigned Fibonacci(uint32 N);
+
+		/** Binary splitting product tree, so the expensive multiplications have balanced operands. */
+		static FBigUnsigned Factorial(uint32 N);
+
+	private:
+		static FBigUnsigned FromLimbs(const uint32* Data, int32 Num);
+		static FBigUnsigned MultiplySchoolbook(const FBigUnsigned& Lhs, const FBigUnsigned& Rhs);
+		static FBigUnsigned MultiplyKaratsuba(const FBigUnsigned& Lhs, const FBigUnsigned& Rhs);
+		static FBigUnsigned RangeProduct(uint32 First, uint32 Last);
+
+		void MultiplySmall(uint32 Value);
+		void AddShifted(const FBigUnsigned& Value, int32 Shift);
+		void Trim();
+
+		// No leading zero limbs, zero is empty
+		TArray<uint32> Limbs;
+	};
+}
@@ -2,28 +2,203 @@
 
 
 #include "Science/ScienceFuncLib.h"
+#include "Science/BigInteger.h"
+#include "Async/ParallelFor.h"
 
-int32 UScienceFuncLib::Fibonacci(int32 Value)
+namespace
 {
-	//check(Value >= 0);
-	if (Value < 0)
+	template<typename ValueType, int32 Size>
+	struct TLookupTable
+	{
+		ValueType Values[Size]{};
+
+		constexpr ValueType operator[](int32 Index) const { return Values[Index]; }
+	};
+
+	constexpr TLookupTable<int64, UScienceFuncLib::MaxFibonacciInt64 + 1> MakeFibonacciTable()
+	{
+		TLookupTable<int64, UScienceFuncLib::MaxFibonacciInt64 + 1> Table;
+		Table.Values[1] = 1;
+		for (int32 Index = 2; Index <= UScienceFuncLib::MaxFibonacciInt64; ++Index)
+		{
+			Table.Values[Index] = Table.Values[Index - 1] + Table.Values[Index - 2];
+		}
+		return Table;
+	}
+
+	constexpr TLookupTable<int64, UScienceFuncLib::MaxFactorialInt64 + 1> MakeFactorialTable()
+	{
+		TLookupTable<int64, UScienceFuncLib::MaxFactorialInt64 + 1> Table;
+		Table.Values[0] = 1;
+		for (int32 Index = 1; Index <= UScienceFuncLib::MaxFactorialInt64; ++Index)
+		{
+			Table.Values[Index] = Table.Values[Index - 1] * Index;
+		}
+		return Table;
+	}
+
+	// The int32 functions read the same tables, the limits below guarantee the values fit
+	constexpr auto FibonacciTable = MakeFibonacciTable();
+	constexpr auto FactorialTable = MakeFactorialTable();
+
+	constexpr bool FollowsFibonacciRecurrence()
+	{
+		for (int32 Index = 2; Index <= UScienceFuncLib::MaxFibonacciInt64; ++Index)
+		{
+			if (FibonacciTable[Index] != FibonacciTable[Index - 1] + FibonacciTable[Index - 2]) return false;
+		}
+		return FibonacciTable[0] == 0 && FibonacciTable[1] == 1;
+	}
+
+	constexpr bool FollowsFactorialRecurrence()
+	{
+		for (int32 Index = 1; Index <= UScienceFuncLib::MaxFactorialInt64; ++Index)
+		{
+			if (FactorialTable[Index] / Index != FactorialTable[Index - 1] || FactorialTable[Index] % Index != 0) return false;
+		}
+		return FactorialTable[0] == 1;
+	}
+
+	static_assert(FollowsFibonacciRecurrence(), "Fibonacci table doesn't follow F(n) = F(n-1) + F(n-2)");
+	static_assert(FollowsFactorialRecurrence(), "Factorial table doesn't follow n! = n * (n-1)!");
+
+	static_assert(FibonacciTable[UScienceFuncLib::MaxFibonacciInt32] <= MAX_int32
+		&& FibonacciTable[UScienceFuncLib::MaxFibonacciInt32 + 1] > MAX_int32, "MaxFibonacciInt32 is the last Fibonacci number in int32");
+	static_assert(static_cast<uint64>(FibonacciTable[UScienceFuncLib::MaxFibonacciInt64 - 1]) + FibonacciTable[UScienceFuncLib::MaxFibonacciInt64] > MAX_int64,
+		"MaxFibonacciInt64 is the last Fibonacci number in int64");
+	static_assert(FactorialTable[UScienceFuncLib::MaxFactorialInt32] <= MAX_int32
+		&& FactorialTable[UScienceFuncLib::MaxFactorialInt32 + 1] > MAX_int32, "MaxFactorialInt32 is the last factorial in int32");
+	static_assert(FactorialTable[UScienceFuncLib::MaxFactorialInt64] > MAX_int64 / (UScienceFuncLib::MaxFactorialInt64 + 1),
+		"MaxFactorialInt64 is the last factorial in int64");
+
+	bool IsInRange(int32 Value, int32 MaxValue)
+	{
+		return Value >= 0 && Value <= MaxValue;
+	}
+
+	FString FormatInputError(const TCHAR* FunctionName, int32 Value, int32 MaxValue, const TCHAR* TypeName)
+	{
+		return Value < 0
+			? FString::Printf(TEXT("Invalid input for %s: %i"), FunctionName, Value)
+			: FString::Printf(TEXT("%s of %i overflows %s, max input is %i"), FunctionName, Value, TypeName, MaxValue);
+	}
+
+	// "Log once" means one error per invalid call, not per process: a one-time guard would hide the error from every
+	// later caller, including automation tests that expect it. Batches go through EvaluateBatch and log one summary.
+	bool IsValidInput(const TCHAR* FunctionName, int32 Value, int32 MaxValue, const TCHAR* TypeName)
+	{
+		if (IsInRange(Value, MaxValue)) return true;
+
+		UE_LOG(LogTemp, Error, TEXT("%s"), *FormatInputError(FunctionName, Value, MaxValue, TypeName));
+		return false;
+	}
+
+	// Elements per task, a lookup is a few cycles so small arrays stay on the calling thread
+	constexpr int32 BatchChunkSize = 4096;
+
+	/**
+	 * Table lookup of every value, -1 for values out of range.
+	 * Invalid values are counted instead of logged one by one, the whole batch reports a single error.
+	 */
+	template<typename TableType>
+	TArray<int32> EvaluateBatch(const TArray<int32>& Values, const TableType& Table, const TCHAR* FunctionName, int32 MaxValue, bool bLogNegative)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Invalid input for Fibonacci: %i"), Value);
+		TArray<int32> Results;
+		Results.SetNumUninitialized(Values.Num());
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Values.Num(), BatchChunkSize);
+		TArray<int32> ChunkNumInvalid;
+		TArray<int32> ChunkFirstInvalid;
+		ChunkNumInvalid.SetNumZeroed(NumChunks);
+		ChunkFirstInvalid.Init(INDEX_NONE, NumChunks);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+			{
+				const int32 Start = ChunkIndex * BatchChunkSize;
+				const int32 End = FMath::Min(Start + BatchChunkSize, Values.Num());
+				for (int32 Index = Start; Index < End; ++Index)
+				{
+					const int32 Value = Values[Index];
+					if (IsInRange(Value, MaxValue))
+					{
+						Results[Index] = static_cast<int32>(Table[Value]);
+						continue;
+					}
+
+					Results[Index] = -1;
+					if (Value < 0 && !bLogNegative) continue;
+
+					if (ChunkNumInvalid[ChunkIndex]++ == 0)
+					{
+						ChunkFirstInvalid[ChunkIndex] = Index;
+					}
+				}
+			}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+		int32 NumInvalid = 0;
+		int32 FirstInvalid = INDEX_NONE;
+		for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+		{
+			FirstInvalid = FirstInvalid == INDEX_NONE ? ChunkFirstInvalid[ChunkIndex] : FirstInvalid;
+			NumInvalid += ChunkNumInvalid[ChunkIndex];
+		}
+		if (NumInvalid > 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%sBatch: %i of %i inputs are invalid, first at index %i: %s"), FunctionName, NumInvalid, Values.Num(), FirstInvalid,
+				*FormatInputError(FunctionName, Values[FirstInvalid], MaxValue, TEXT("int32")));
+		}
+
+		return Results;
 	}
-	return Value <= 1 ? Value : Fibonacci(Value - 1) + Fibonacci(Value - 2);
+}
+
+int32 UScienceFuncLib::Fibonacci(int32 Value)
+{
+	if (!IsValidInput(TEXT("Fibonacci"), Value, MaxFibonacciInt32, TEXT("int32"))) return -1;
+	return static_cast<int32>(FibonacciTable[Value]);
+}
+
+int64 UScienceFuncLib::Fibonacci64(int32 Value)
+{
+	if (!IsValidInput(TEXT("Fibonacci"), Value, MaxFibonacciInt64, TEXT("int64"))) return -1;
+	return FibonacciTable[Value];
 }
 
 int32 UScienceFuncLib::Factorial(int32 Value)
 {
 	if (Value < 0) return -1;
-	
-	int32 Fac = 1;
-	for (int32 i = 1; i <= Value; ++i)
-	{
-		Fac *= i;
-	}
+	if (!IsValidInput(TEXT("Factorial"), Value, MaxFactorialInt32, TEXT("int32"))) return -1;
+	return static_cast<int32>(FactorialTable[Value]);
+}
+
+int64 UScienceFuncLib::Factorial64(int32 Value)
+{
+	if (Value < 0) return -1;
+	if (!IsValidInput(TEXT("Factorial"), Value, MaxFactorialInt64, TEXT("int64"))) return -1;
+	return FactorialTable[Value];
+}
+
+TArray<int32> UScienceFuncLib::FibonacciBatch(const TArray<int32>& Values)
+{
+	return EvaluateBatch(Values, FibonacciTable, TEXT("Fibonacci"), MaxFibonacciInt32, true);
+}
 
-	return Fac;
+TArray<int32> UScienceFuncLib::FactorialBatch(const TArray<int32>& Values)
+{
+	// Negative input is a silent -1, same as Factorial
+	return EvaluateBatch(Values, FactorialTable, TEXT("Factorial"), MaxFactorialInt32, false);
+}
+
+FString UScienceFuncLib::FibonacciBig(int32 Value)
+{
+	if (!IsValidInput(TEXT("FibonacciBig"), Value, MaxFibonacciBig, TEXT("the big integer limit"))) return FString();
+	return TestProject::FBigUnsigned::Fibonacci(Value).ToString();
+}
+
+FString UScienceFuncLib::FactorialBig(int32 Value)
+{
+	if (!IsValidInput(TEXT("FactorialBig"), Value, MaxFactorialBig, TEXT("the big integer limit"))) return FString();
+	return TestProject::FBigUnsigned::Factorial(Value).ToString();
 }
 
 
@@ -14,9 +14,51 @@ class TESTPROJECT_API UScienceFuncLib : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 public:
+	// Largest inputs whose result fits the return type
+	static constexpr int32 MaxFibonacciInt32 = 46;
+	static constexpr int32 MaxFibonacciInt64 = 92;
+	static constexpr int32 MaxFactorialInt32 = 12;
+	static constexpr int32 MaxFactorialInt64 = 20;
+
+	// Largest inputs of the big integer functions, keeps a single Blueprint call around a second of work and a few MB of digits
+	static constexpr int32 MaxFibonacciBig = 1000000;
+	static constexpr int32 MaxFactorialBig = 100000;
+
+	/** Compile-time table lookup. Returns -1 and logs an error for negative inputs and results that don't fit int32. */
 	UFUNCTION(BlueprintPure, Category="Science")
 	static int32 Fibonacci(int32 Value);
+
+	/** Same as Fibonacci but covers inputs up to MaxFibonacciInt64. */
+	UFUNCTION(BlueprintPure, Category = "Science")
+	static int64 Fibonacci64(int32 Value);
 	
+	/** Compile-time table lookup. Returns -1 for negative inputs, logs an error and returns -1 for results that don't fit int32. */
+	UFUNCTION(BlueprintPure, Category = "Science")
+	static int32 Factorial(int32 Value);
+
+	/** Same as Factorial but covers inputs up to MaxFactorialInt64. */
 	UFUNCTION(BlueprintPure, Category = "Science")
-	static int32 Factorial(int32 Value);	
+	static int64 Factorial64(int32 Value);
+
+	/**
+	 * Fibonacci of every value in one native call, large arrays are split across worker threads.
+	 * Invalid values give -1 like Fibonacci, but the batch logs a single error for all of them.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Science")
+	static TArray<int32> FibonacciBatch(const TArray<int32>& Values);
+
+	/**
+	 * Factorial of every value in one native call, large arrays are split across worker threads.
+	 * Invalid values give -1 like Factorial, but the batch logs a single error for all overflowing ones.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Science")
+	static TArray<int32> FactorialBatch(const TArray<int32>& Values);
+
+	/** Exact decimal Fibonacci number, empty and logs an error for negative inputs and inputs above MaxFibonacciBig. */
+	UFUNCTION(BlueprintCallable, Category = "Science")
+	static FString FibonacciBig(int32 Value);
+
+	/** Exact decimal factorial, empty and logs an error for negative inputs and inputs above MaxFactorialBig. */
+	UFUNCTION(BlueprintCallable, Category = "Science")
+	static FString FactorialBig(int32 Value);
 };
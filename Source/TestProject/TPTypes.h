@@ -12,6 +12,19 @@ enum class EInventoryItemType : uint8
 	CONE
 };
 
+// Number of EInventoryItemType values, used to size per-type arrays. Update when a type is added.
+constexpr int32 InventoryItemTypeCount = static_cast<int32>(EInventoryItemType::CONE) + 1;
+
+UENUM(BlueprintType)
+enum class EInventoryAddResult : uint8
+{
+	Added = 0,
+	NegativeScore,
+	OverLimit,
+	// Valid on its own, dropped because another item of the same batch failed
+	NotCommitted
+};
+
 USTRUCT(BlueprintType)
 struct FInventoryData
 {
@@ -1,4 +1,6 @@
 #include "Tests/TestUtils.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/App.h"
 
 namespace TestProject
 {
@@ -27,4 +29,39 @@ namespace TestProject
 		}
 		return nullptr;
 	}
+
+	FixedTimeStepScope::FixedTimeStepScope(UWorld* World, double FixedDeltaTime, float TimeDilation)
+	{
+		if (FixedDeltaTime <= 0.0) return;
+
+		bEnabled = true;
+		bPrevUseFixedTimeStep = FApp::UseFixedTimeStep();
+		PrevFixedDeltaTime = FApp::GetFixedDeltaTime();
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(FixedDeltaTime);
+
+		if (World && World->GetWorldSettings())
+		{
+			WorldSettings = World->GetWorldSettings();
+			PrevTimeDilation = WorldSettings->TimeDilation;
+			WorldSettings->SetTimeDilation(TimeDilation);
+		}
+	}
+
+	FixedTimeStepScope::~FixedTimeStepScope()
+	{
+		if (!bEnabled) return;
+
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([bUseFixedTimeStep = bPrevUseFixedTimeStep, FixedDeltaTime = PrevFixedDeltaTime,
+			Settings = WorldSettings, TimeDilation = PrevTimeDilation]()
+			{
+				FApp::SetUseFixedTimeStep(bUseFixedTimeStep);
+				FApp::SetFixedDeltaTime(FixedDeltaTime);
+				if (Settings.IsValid())
+				{
+					Settings->SetTimeDilation(TimeDilation);
+				}
+				return true;
+			}));
+	}
 }
\ No newline at end of file
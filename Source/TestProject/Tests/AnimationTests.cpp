@@ -7,7 +7,10 @@
 #include "GameFramework/Character.h"
 #include "Tests/TestUtils.h"
 #include "Utils/JsonUtils.h"
+#include "Utils/RecordingBinaryUtils.h"
 #include "Utils/BoneRecordingUtils.h"
+#include "Utils/PoseComparison.h"
+#include "Utils/OfflineAnimationUtils.h"
 
 using namespace TestProject;
 
@@ -28,15 +31,39 @@ namespace
 		return nullptr;
 	}
 
+	const TCHAR* AnimationTestCharacterClassPath = TEXT("/Game/Tests/BP_AnimationTestCharacter.BP_AnimationTestCharacter_C");
+
+	// UBonesPositionRecorder streams *.tprec, prefer a fresh recording over the committed JSON
+	TFuture<TSharedPtr<FRecordingAnimationData>> LoadAnimationDataAsync()
+	{
+		const FString BinaryDataPath = FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.tprec");
+		if (!FPaths::FileExists(BinaryDataPath))
+		{
+			return TRecordingSerializer<FRecordingAnimationData>::ReadAsync(FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.json"));
+		}
+
+		return Async(EAsyncExecution::TaskGraph, [BinaryDataPath]() -> TSharedPtr<FRecordingAnimationData>
+			{
+				TSharedPtr<FRecordingAnimationData> AnimationData = MakeShared<FRecordingAnimationData>();
+				return RecordingBinaryUtils::ReadSkeletonData(BinaryDataPath, *AnimationData) ? AnimationData : nullptr;
+			});
+	}
+
+	/**
+	 * Compares every frame against the recorded pose interpolated to the current world time.
+	 * Errors are accumulated in a FPoseComparisonReport and reported once when the recording ends.
+	 */
 	class FCompareAnimationToSavedData : public IAutomationLatentCommand
 	{
 	public:
 		FCompareAnimationToSavedData(
+			FAutomationTestBase& InTest,
 			UWorld* InWorld, 
-			FRecordingAnimationData InDataToCompareTo, 
+			TSharedFuture<TSharedPtr<FRecordingAnimationData>> InDataToCompareTo, 
 			USkeletalMeshComponent* InSkeletalMeshComponent)
-			:World(InWorld),
-			DataToCompareTo(InDataToCompareTo),
+			:Test(InTest),
+			World(InWorld),
+			DataFuture(MoveTemp(InDataToCompareTo)),
 			SkeletalMeshComponent(InSkeletalMeshComponent)
 		{
 		}
@@ -45,62 +72,83 @@ namespace
 		{
 			if (!World) return true;
 
+			if (!Cursor.IsValid())
+			{
+				if (!DataFuture.IsReady()) return false;
+				if (!DataFuture.Get()) return true;
+				if (!Initialize(*DataFuture.Get())) return true;
+			}
+
 			UAnimInstance* AnimInstance = SkeletalMeshComponent->GetAnimInstance();
 			if (!AnimInstance)
 			{
 				return true;
 			}
 
-			float CurrentTime = World->TimeSeconds;
-			float RecordTime = DataToCompareTo.SkeletonRecordings[Index].WorldTime;
+			const float CurrentTime = World->TimeSeconds;
+			if (CurrentTime < Cursor->GetStartTime()) return false;
 
-			if (FMath::IsNearlyEqual(CurrentTime, RecordTime, 0.005))
+			Cursor->Sample(FMath::Min(CurrentTime, Cursor->GetEndTime()), RecordedPose);
+			for (int32 RecordedBoneIndex = 0; RecordedBoneIndex < SkeletonBoneIndices.Num(); ++RecordedBoneIndex)
 			{
-				FReferenceSkeleton ReferenceSkeleton = SkeletalMeshComponent->SkeletalMesh->GetRefSkeleton();
-				int32 BoneCount = ReferenceSkeleton.GetNum();
-
-				for (int32 BoneIndex = 0; BoneIndex < BoneCount; ++BoneIndex)
+				const int32 BoneIndex = SkeletonBoneIndices[RecordedBoneIndex];
+				if (BoneIndex == INDEX_NONE)
 				{
-					FRecordingBoneData RecordingBoneData = DataToCompareTo.SkeletonRecordings[Index].BoneValues[BoneIndex];
-
-					FName BoneName = ReferenceSkeleton.GetBoneName(BoneIndex);
-					FTransform BoneTransform = SkeletalMeshComponent->GetBoneTransform(BoneIndex);
-
-					if (RecordingBoneData.Name.IsEqual(BoneName))
-					{
-						FString ErrorMessage = FString::Printf(TEXT("On animation time %s in bone %s "), 
-							*FString::SanitizeFloat(DataToCompareTo.SkeletonRecordings[Index].WorldTime),
-							*BoneName.ToString());
-						if (!RecordingBoneData.Position.Equals(BoneTransform.GetLocation(), 30.f))
-						{
-							FString ErrorPositionMessage = FString::Printf(TEXT("%s recorded position %s is not equal actual %s"),
-								*ErrorMessage, *RecordingBoneData.Position.ToString(), *BoneTransform.GetLocation().ToString());
-							UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorPositionMessage);
-						}
-						if (!RecordingBoneData.Rotation.Equals(BoneTransform.Rotator(), 30.f))
-						{
-							FString ErrorRotationMessage = FString::Printf(TEXT("%s recorded rotation %s is not equal actual %s"),
-								*ErrorMessage, *RecordingBoneData.Rotation.ToString(), *BoneTransform.Rotator().ToString());
-							UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorRotationMessage);
-						}
-					}
+					// Bones missing from the mesh aren't compared
+					ActualPose.SetBone(RecordedBoneIndex,
+						FVector(RecordedPose.PositionX[RecordedBoneIndex], RecordedPose.PositionY[RecordedBoneIndex], RecordedPose.PositionZ[RecordedBoneIndex]),
+						FRotator(RecordedPose.RotationPitch[RecordedBoneIndex], RecordedPose.RotationYaw[RecordedBoneIndex], RecordedPose.RotationRoll[RecordedBoneIndex]));
+					continue;
 				}
+				const FTransform BoneTransform = SkeletalMeshComponent->GetBoneTransform(BoneIndex);
+				ActualPose.SetBone(RecordedBoneIndex, BoneTransform.GetLocation(), BoneTransform.GetRotation());
+			}
+			Report->AddFrame(RecordedPose, ActualPose);
+
+			if (CurrentTime < Cursor->GetEndTime()) return false;
 
-				if (++Index >= DataToCompareTo.SkeletonRecordings.Num()) return true;
+			if (Report->GetNumMismatches() > 0)
+			{
+				Test.AddError(Report->ToString());
 			}
-			else if (CurrentTime > RecordTime)
+			else
 			{
-				if (++Index >= DataToCompareTo.SkeletonRecordings.Num()) return true;
+				Test.AddInfo(Report->ToString());
 			}
-			return false;
+			return true;
 		}
 
 	private:
+		bool Initialize(const FRecordingAnimationData& AnimationData)
+		{
+			Cursor = MakeUnique<FRecordedPoseCursor>(AnimationData);
+			if (Cursor->IsEmpty()) return false;
+
+			// Recorded bone index -> skeleton bone index, resolved by name once
+			const FReferenceSkeleton& ReferenceSkeleton = SkeletalMeshComponent->SkeletalMesh->GetRefSkeleton();
+			SkeletonBoneIndices.SetNum(Cursor->GetNumBones());
+			for (int32 RecordedBoneIndex = 0; RecordedBoneIndex < Cursor->GetNumBones(); ++RecordedBoneIndex)
+			{
+				SkeletonBoneIndices[RecordedBoneIndex] = ReferenceSkeleton.FindBoneIndex(Cursor->GetBoneName(RecordedBoneIndex));
+			}
+
+			ActualPose.SetNumBones(Cursor->GetNumBones());
+			Report = MakeUnique<FPoseComparisonReport>(Cursor->GetBoneNames(), PositionTolerance, RotationTolerance);
+			return true;
+		}
+
+		static constexpr float PositionTolerance = 30.0f;
+		static constexpr float RotationTolerance = 30.0f;
+
+		FAutomationTestBase& Test;
 		const UWorld* World;
-		FRecordingAnimationData DataToCompareTo;
+		TSharedFuture<TSharedPtr<FRecordingAnimationData>> DataFuture;
 		USkeletalMeshComponent* SkeletalMeshComponent;
-		int32 Index{ 0 };
-		float WorldStartTime{ 0.0f };
+		TUniquePtr<FRecordedPoseCursor> Cursor;
+		TUniquePtr<FPoseComparisonReport> Report;
+		TArray<int32> SkeletonBoneIndices;
+		FPoseSoA RecordedPose;
+		FPoseSoA ActualPose;
 	};
 }
 
@@ -109,6 +157,9 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWalkAnimationIsCorrect, "TestProject.Animation
 
 bool FWalkAnimationIsCorrect::RunTest(const FString& Parameters)
 {
+	// The recording is parsed while the level loads
+	const TSharedFuture<TSharedPtr<FRecordingAnimationData>> AnimationData = LoadAnimationDataAsync().Share();
+
 	const auto Level = LevelScope("/Game/Tests/AnimationTestLevelMap");
 
 	UWorld* World = GetTestGameWorld();
@@ -123,12 +174,13 @@ bool FWalkAnimationIsCorrect::RunTest(const FString& Parameters)
 	USkeletalMesh* SkeletalMesh = AnimTestChar->GetMesh()->SkeletalMesh;
 	if (!TestNotNull("Character for animation test has skeletal mesh", SkeletalMesh)) return false;
 
-	FRecordingAnimationData AnimationData;
-	JsonUtils::ReadSkeletonData(FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.json"), AnimationData);
-
-	AnimTestChar->SetActorTransform(AnimationData.InitialTransform);
-
-	ADD_LATENT_AUTOMATION_COMMAND(FCompareAnimationToSavedData(World, AnimationData, SkeletalMeshComponent));
+	ADD_LATENT_AUTOMATION_COMMAND(TWaitForFutureLatentCommand<TSharedPtr<FRecordingAnimationData>>(AnimationData,
+		[this, AnimTestChar](const TSharedPtr<FRecordingAnimationData>& Data)
+		{
+			if (!TestTrue("Animation data is read", Data.IsValid())) return;
+			AnimTestChar->SetActorTransform(Data->InitialTransform);
+		}));
+	ADD_LATENT_AUTOMATION_COMMAND(FCompareAnimationToSavedData(*this, World, AnimationData, SkeletalMeshComponent));
 	//AnimTestChar->GetMesh()->GetAnimInstance()->OnPlayMontageNotifyBegin.AddDynamic(TEXT("L"),
 
 	//FInputData InputData;
@@ -137,4 +189,48 @@ bool FWalkAnimationIsCorrect::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWalkAnimationIsCorrectOffline, "TestProject.Animation.WalkAnimationIsCorrectOffline",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+bool FWalkAnimationIsCorrectOffline::RunTest(const FString& Parameters)
+{
+	// No level is loaded, the character defaults are evaluated at the recorded times directly
+	const TSharedPtr<FRecordingAnimationData> AnimationData = LoadAnimationDataAsync().Get();
+	if (!TestTrue("Animation data is read", AnimationData.IsValid())) return false;
+	if (!TestTrue("Animation data isn't empty", AnimationData->SkeletonRecordings.Num() > 0)) return false;
+
+	const UClass* CharacterClass = LoadClass<ACharacter>(nullptr, AnimationTestCharacterClassPath);
+	if (!TestNotNull("Character class for animation testing is loaded", CharacterClass)) return false;
+
+	const ACharacter* CharacterDefaults = CharacterClass->GetDefaultObject<ACharacter>();
+	FOfflineAnimationSetup Setup;
+	if (!TestTrue("Character plays a single animation", OfflineAnimationUtils::MakeSetup(CharacterDefaults->GetMesh(), AnimationData->InitialTransform, Setup))) return false;
+
+	FRecordedPoseCursor Cursor(*AnimationData);
+	TArray<float> WorldTimes;
+	for (const FRecordingSkeletonData& Frame : AnimationData->SkeletonRecordings)
+	{
+		WorldTimes.Add(Frame.WorldTime);
+	}
+
+	TArray<FPoseSoA> ActualPoses;
+	if (!TestTrue("Poses are evaluated", OfflineAnimationUtils::EvaluatePoses(Setup, Cursor.GetBoneNames(), WorldTimes, ActualPoses))) return false;
+
+	FPoseComparisonReport Report(Cursor.GetBoneNames(), 30.0f, 30.0f);
+	FPoseSoA RecordedPose;
+	for (int32 FrameIndex = 0; FrameIndex < WorldTimes.Num(); ++FrameIndex)
+	{
+		Cursor.Sample(WorldTimes[FrameIndex], RecordedPose);
+		Report.AddFrame(RecordedPose, ActualPoses[FrameIndex]);
+	}
+
+	if (Report.GetNumMismatches() > 0)
+	{
+		AddError(Report.ToString());
+		return false;
+	}
+	AddInfo(Report.ToString());
+	return true;
+}
+
 #endif
\ No newline at end of file
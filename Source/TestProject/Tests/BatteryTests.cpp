@@ -7,10 +7,17 @@
 #include "Misc/AutomationTest.h"
 #include "Tests/TestUtils.h"
 #include "Items/Battery.h"
+#include "Items/BatteryPool.h"
+#include "Utils/BenchmarkUtils.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatteryTests, "TestProject.Items.Battery",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatteryPoolMatchesBattery, "TestProject.Items.BatteryPool.MatchesBattery",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_BENCHMARK_TEST(FBatteryBenchmark, "TestProject.Items.Battery.Benchmark");
+
 bool FBatteryTests::RunTest(const FString& Parameters)
 {
 	using namespace TestProject;
@@ -67,5 +74,154 @@ bool FBatteryTests::RunTest(const FString& Parameters)
 	return true;
 }
 
+bool FBatteryPoolMatchesBattery::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	// Not a multiple of the SIMD width so the scalar tail is covered too
+	constexpr int32 NumBatteries = 1027;
+
+	FRandomStream Random(42);
+	TArray<Battery> Batteries;
+	FBatteryPool Pool;
+	for (int32 i = 0; i < NumBatteries; ++i)
+	{
+		const float Percent = Random.FRandRange(-0.2f, 1.2f);
+		Batteries.Emplace(Percent);
+		Pool.Add(Percent);
+	}
+
+	const auto PercentsAreIdentical = [&]()
+		{
+			for (int32 i = 0; i < NumBatteries; ++i)
+			{
+				const float PoolPercent = Pool.GetPercent(i);
+				const float BatteryPercent = Batteries[i].GetPercent();
+				if (FMemory::Memcmp(&PoolPercent, &BatteryPercent, sizeof(float)) != 0) return false;
+			}
+			return true;
+		};
+
+	const auto ColorsAreIdentical = [&]()
+		{
+			TArray<uint8> ColorIndices;
+			Pool.ClassifyColors(ColorIndices);
+			for (int32 i = 0; i < NumBatteries; ++i)
+			{
+				if (FBatteryPool::GetColorByIndex(ColorIndices[i]) != Batteries[i].GetColor()) return false;
+			}
+			return true;
+		};
+
+	AddInfo("Pool is filled like batteries are constructed");
+	TestTrueExpr(PercentsAreIdentical());
+	TestTrueExpr(ColorsAreIdentical());
+
+	AddInfo("Pool charge/discharge");
+	for (int32 Step = 0; Step < 15; ++Step)
+	{
+		const bool bCharge = Random.FRand() < 0.5f;
+		bCharge ? Pool.ChargeAll() : Pool.DischargeAll();
+		for (Battery& Item : Batteries)
+		{
+			bCharge ? Item.Charge() : Item.Discharge();
+		}
+		if (!TestTrueExpr(PercentsAreIdentical())) return false;
+		if (!TestTrueExpr(ColorsAreIdentical())) return false;
+	}
+
+	AddInfo("Pool per battery delta");
+	TArray<float> Deltas;
+	for (int32 i = 0; i < NumBatteries; ++i)
+	{
+		// Multiples of the charge amount can be replayed on a Battery
+		Deltas.Add(Random.RandRange(-3, 3) * Battery::ChargeAmount);
+	}
+	Pool.ApplyDelta(Deltas);
+	for (int32 i = 0; i < NumBatteries; ++i)
+	{
+		Batteries[i] = Battery(Batteries[i].GetPercent() + Deltas[i]);
+	}
+	TestTrueExpr(PercentsAreIdentical());
+	TestTrueExpr(ColorsAreIdentical());
+
+	AddInfo("Pool threshold search");
+	TArray<int32> LowIndices;
+	Pool.FindAtOrBelow(0.3f, LowIndices);
+	TArray<int32> ExpectedIndices;
+	for (int32 i = 0; i < NumBatteries; ++i)
+	{
+		if (Batteries[i].GetPercent() <= 0.3f)
+		{
+			ExpectedIndices.Add(i);
+		}
+	}
+	TestTrueExpr(LowIndices == ExpectedIndices);
+
+	return true;
+}
+
+bool FBatteryBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	FBenchmarkScope Benchmark(*this);
+
+	TArray<Battery> Batteries;
+	for (int32 i = 0; i < 1024; ++i)
+	{
+		Batteries.Emplace(FMath::Frac(i * 0.37f));
+	}
+
+	Benchmark.Run("Charge 1024", [&Batteries]()
+		{
+			for (Battery& Item : Batteries)
+			{
+				Item.Charge();
+			}
+			DoNotOptimize(Batteries.GetData());
+		});
+	Benchmark.Run("Discharge 1024", [&Batteries]()
+		{
+			for (Battery& Item : Batteries)
+			{
+				Item.Discharge();
+			}
+			DoNotOptimize(Batteries.GetData());
+		});
+	Benchmark.Run("GetColor 1024", [&Batteries]()
+		{
+			for (const Battery& Item : Batteries)
+			{
+				DoNotOptimize(Item.GetColor());
+			}
+		});
+
+	FBatteryPool Pool;
+	for (const Battery& Item : Batteries)
+	{
+		Pool.Add(Item);
+	}
+
+	Benchmark.Run("Pool ChargeAll 1024", [&Pool]()
+		{
+			Pool.ChargeAll();
+			DoNotOptimize(Pool.GetPercents().GetData());
+		});
+	Benchmark.Run("Pool DischargeAll 1024", [&Pool]()
+		{
+			Pool.DischargeAll();
+			DoNotOptimize(Pool.GetPercents().GetData());
+		});
+	TArray<uint8> ColorIndices;
+	Benchmark.Run("Pool ClassifyColors 1024", [&Pool, &ColorIndices]()
+		{
+			Pool.ClassifyColors(ColorIndices);
+			DoNotOptimize(ColorIndices.GetData());
+		});
+
+	return true;
+}
+
 #endif
 
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#if (WITH_DEV_AUTOMATION_TESTS || WITH_PERF_AUTOMATION_TESTS)
+
+#include "Tests/BenchmarkTests.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/TestUtils.h"
+#include "Utils/BenchmarkUtils.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBenchmarkRegressionIsDetected, "TestProject.Benchmark.RegressionIsDetected",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+using namespace TestProject;
+
+bool FBenchmarkRegressionIsDetected::RunTest(const FString& Parameters)
+{
+	FPerfBaseline Baseline;
+	Baseline.Median = 100.0;
+	Baseline.MedianAbsoluteDeviation = 2.0;
+
+	// Median of the current run, its MAD and whether it is a regression with 10% tolerance and 3 MADs of noise
+	const TArray<TestPayload<TPair<double, double>, bool>> TestData
+	{
+		{ { 90.0, 1.0 }, false },
+		{ { 115.0, 1.0 }, false },
+		{ { 117.0, 1.0 }, true },
+		{ { 117.0, 3.0 }, false },
+		{ { 200.0, 2.0 }, true }
+	};
+
+	for (const auto& Data : TestData)
+	{
+		FBenchmarkResult Result;
+		Result.Median = Data.TestValue.Key;
+		Result.MedianAbsoluteDeviation = Data.TestValue.Value;
+
+		const FString InfoString = FString::Printf(TEXT("median %f, MAD %f"), Result.Median, Result.MedianAbsoluteDeviation);
+		TestEqual(InfoString, FBenchmarkScope::IsRegression(Result, Baseline, 0.1, 3.0), Data.ExpectedValue);
+	}
+
+	TestFalse("Machine class isn't empty", FBenchmarkScope::GetMachineClass().IsEmpty());
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -3,13 +3,15 @@
 
 #include "Tests/Components/BonesPositionRecorder.h"
 #include "GameFramework/Character.h"
-#include "Tests/Utils/JsonUtils.h"
 
 using namespace TestProject;
 
 UBonesPositionRecorder::UBonesPositionRecorder()
 {
-	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Sample after animation has been evaluated for the frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
 }
 
 void UBonesPositionRecorder::BeginPlay()
@@ -25,55 +27,106 @@ void UBonesPositionRecorder::BeginPlay()
 
     SkeletalMeshComponent = Character->GetMesh();
     SkeletalMesh = Character->GetMesh()->SkeletalMesh;
+    check(SkeletalMesh);
 
-    AnimationData.InitialTransform = GetOwner()->GetActorTransform();
+    TArray<FName> BoneNames;
+    const FReferenceSkeleton& ReferenceSkeleton = SkeletalMesh->GetRefSkeleton();
+    for (int32 BoneIndex = 0; BoneIndex < ReferenceSkeleton.GetNum(); ++BoneIndex)
+    {
+        BoneNames.Add(ReferenceSkeleton.GetBoneName(BoneIndex));
+    }
+    PoseLayout = FRecordingPoseLayout(BoneNames.Num());
+
+    // World space conversion happens on the writer thread, the game thread only copies the component space pose
+    FRecordEncoder Encoder;
+    Encoder.RecordSize = PoseLayout.Size;
+    Encoder.Encode = [Layout = PoseLayout](const uint8* Record, double* OutFrame)
+    {
+        const FTransform ComponentToWorld = RecordingBinaryUtils::ArrayToTransform(Layout.ComponentToWorld(Record));
+        const FVector3f* Positions = Layout.Positions(Record);
+        const FQuat4f* Rotations = Layout.Rotations(Record);
+
+        *OutFrame++ = Layout.WorldTime(Record);
+        for (int32 BoneIndex = 0; BoneIndex < Layout.NumBones; ++BoneIndex)
+        {
+            const FVector Position = ComponentToWorld.TransformPosition(FVector(Positions[BoneIndex]));
+            const FRotator Rotation = (ComponentToWorld.GetRotation() * FQuat(Rotations[BoneIndex])).Rotator();
+
+            *OutFrame++ = Position.X;
+            *OutFrame++ = Position.Y;
+            *OutFrame++ = Position.Z;
+            *OutFrame++ = Rotation.Pitch;
+            *OutFrame++ = Rotation.Yaw;
+            *OutFrame++ = Rotation.Roll;
+        }
+    };
+
+    if (!Writer.Open(GenerateFileName(), ERecordingKind::Animation, AnimationComponentsPerSlot, BoneNames,
+        GetOwner()->GetActorTransform(), BufferCapacity, MoveTemp(Encoder)))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Animation recording can't be started"));
+        return;
+    }
 
-    GetWorld()->GetTimerManager().SetTimer(SkeletonRecordTimer, this, &UBonesPositionRecorder::RecordSkeletonData, 0.1f, true);
+    if (SampleInterval > 0.0f)
+    {
+        GetWorld()->GetTimerManager().SetTimer(SkeletonRecordTimer, this, &UBonesPositionRecorder::RecordSkeletonData, SampleInterval, true);
+    }
+    else
+    {
+        SetComponentTickEnabled(true);
+    }
+}
+
+void UBonesPositionRecorder::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    RecordSkeletonData();
 }
 
 void UBonesPositionRecorder::RecordSkeletonData()
 {
-    if (!SkeletalMesh)
+    if (!Writer.IsOpen()) return;
+
+    if (!SkeletalMeshComponent->GetAnimInstance())
     {
-        UE_LOG(LogTemp, Error, TEXT("Invalid SkeletalMesh"));
         return;
     }
 
-    FReferenceSkeleton ReferenceSkeleton = SkeletalMesh->GetRefSkeleton();
-    int32 BoneCount = ReferenceSkeleton.GetNum();
-
-    UAnimInstance* AnimInstance = SkeletalMeshComponent->GetAnimInstance();
-    if (!AnimInstance)
+    const TArray<FTransform>& ComponentSpaceTransforms = SkeletalMeshComponent->GetComponentSpaceTransforms();
+    if (ComponentSpaceTransforms.Num() != PoseLayout.NumBones)
     {
+        UE_LOG(LogTemp, Error, TEXT("Invalid SkeletalMesh pose"));
         return;
     }
 
-    FRecordingSkeletonData SkeletonData;
+    uint8* Record = Writer.AcquireRecord();
 
-    SkeletonData.WorldTime = GetWorld()->TimeSeconds;
-    for (int32 BoneIndex = 0; BoneIndex < BoneCount; ++BoneIndex)
-    {
-        FName BoneName = ReferenceSkeleton.GetBoneName(BoneIndex);
-        FTransform BoneTransform = SkeletalMeshComponent->GetBoneTransform(BoneIndex);
+    PoseLayout.WorldTime(Record) = GetWorld()->TimeSeconds;
+    RecordingBinaryUtils::TransformToArray(SkeletalMeshComponent->GetComponentTransform(), PoseLayout.ComponentToWorld(Record));
 
-        FRecordingBoneData BoneData;
-
-        BoneData.Name = BoneName;
-        BoneData.Position = BoneTransform.GetLocation();
-        BoneData.Rotation = BoneTransform.Rotator();
-
-        SkeletonData.BoneValues.Add(BoneData);
+    FVector3f* Positions = PoseLayout.Positions(Record);
+    FQuat4f* Rotations = PoseLayout.Rotations(Record);
+    for (int32 BoneIndex = 0; BoneIndex < PoseLayout.NumBones; ++BoneIndex)
+    {
+        const FTransform& BoneTransform = ComponentSpaceTransforms[BoneIndex];
+        Positions[BoneIndex] = FVector3f(BoneTransform.GetTranslation());
+        Rotations[BoneIndex] = FQuat4f(BoneTransform.GetRotation());
     }
-    AnimationData.SkeletonRecordings.Add(SkeletonData);
+
+    Writer.CommitRecord();
 }
 
 FString UBonesPositionRecorder::GenerateFileName() const
 {
-    return FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.json");
+    return FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.tprec");
 }
 
 void UBonesPositionRecorder::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     Super::EndPlay(EndPlayReason);
-    JsonUtils::WriteSkeletonData(GenerateFileName(), AnimationData);
+
+    GetWorld()->GetTimerManager().ClearTimer(SkeletonRecordTimer);
+    Writer.Finalize();
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "TestProject/Tests/Utils/BoneRecordingUtils.h"
+#include "TestProject/Tests/Utils/RecordingStreamWriter.h"
 #include "BonesPositionRecorder.generated.h"
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
@@ -19,17 +20,31 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
-	
+
+public:
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
 	UFUNCTION()
 	void RecordSkeletonData();
 
 	FString GenerateFileName() const;
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Frames kept in memory before the writer thread flushes them to disk
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "8"))
+	int32 BufferCapacity{ 256 };
+
+	// Zero records every frame
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", Units = "s"))
+	float SampleInterval{ 0.1f };
+
 private:
 	const USkeletalMeshComponent* SkeletalMeshComponent;
 	const USkeletalMesh* SkeletalMesh;
 	FTimerHandle SkeletonRecordTimer;
+	FRecordingPoseLayout PoseLayout;
 
-	FRecordingAnimationData AnimationData;
+	TestProject::FRecordingStreamWriter Writer;
 };
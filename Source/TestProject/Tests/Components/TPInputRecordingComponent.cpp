@@ -6,15 +6,22 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "GameFramework/Character.h"
-#include "TestProject/Tests/Utils/JsonUtils.h"
+#include "TestProject/Tests/Utils/RecordingBinaryUtils.h"
 #include "GameFramework/PlayerInput.h"
+#include "Async/Async.h"
 
 using namespace TestProject;
 
+namespace
+{
+	// Every recorder writes the same fixture, so the conversion of the last recording is shared. Game thread only.
+	TFuture<bool> PendingConversion;
+}
+
 UTPInputRecordingComponent::UTPInputRecordingComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
-
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 
@@ -38,43 +45,143 @@ void UTPInputRecordingComponent::BeginPlay()
 	OwnerCharacter = Cast<ACharacter>(GetOwner());
 	check(OwnerCharacter);
 	InputComp = Cast<UEnhancedInputComponent>(OwnerCharacter->InputComponent);
+	check(InputComp);
+
+	// Every bound action is a slot, actions with several event bindings (e.g. Started and Completed) are recorded once
+	TArray<FName> SlotNames;
+	TSet<const UInputAction*> RecordedActions;
+	for (const TUniquePtr<FEnhancedInputActionEventBinding>& EventBinding : InputComp->GetActionEventBindings())
+	{
+		const UInputAction* Action = EventBinding->GetAction();
+		bool bAlreadyRecorded = false;
+		RecordedActions.Add(Action, &bAlreadyRecorded);
+		if (bAlreadyRecorded) continue;
+
+		SlotNames.Add(FName{Action->GetName()});
+		const FEnhancedInputActionValueBinding& ValueBinding = InputComp->BindActionValue(Action);
+		SlotValueBindings.Add(static_cast<int32>(&ValueBinding - InputComp->GetActionValueBindings().GetData()));
+	}
+
+	InputLayout = FRecordingInputLayout(SlotNames.Num());
+	LastSlotValues.Init(FVector2D::ZeroVector, SlotNames.Num());
+
+	// Changed slots are expanded back to full frames on the writer thread
+	FRecordEncoder Encoder;
+	Encoder.RecordSize = InputLayout.Size;
+	Encoder.Encode = [Layout = InputLayout, Values = LastSlotValues](const uint8* Record, double* OutFrame) mutable
+	{
+		const FRecordingInputChange* Changes = Layout.Changes(Record);
+		for (int32 ChangeIndex = 0; ChangeIndex < Layout.NumChanges(Record); ++ChangeIndex)
+		{
+			Values[Changes[ChangeIndex].Slot] = Changes[ChangeIndex].Value;
+		}
+
+		*OutFrame++ = Layout.WorldTime(Record);
+		for (const FVector2D& Value : Values)
+		{
+			*OutFrame++ = Value.X;
+			*OutFrame++ = Value.Y;
+		}
+	};
+
+	// A previous recording may still be converted from the file that is about to be overwritten
+	WaitForConversion();
+	if (!Writer.Open(GenerateFileName(), ERecordingKind::Input, InputComponentsPerSlot, SlotNames,
+		GetOwner()->GetActorTransform(), BufferCapacity, MoveTemp(Encoder)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Input recording can't be started"));
+		return;
+	}
 
-	InputData.InitialTransform = GetOwner()->GetActorTransform();
-	InputData.Bindings.Add(MakeBindingsData());
+	RecordInputData();
+	if (SampleInterval > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(InputRecordTimer, this, &UTPInputRecordingComponent::RecordInputData, SampleInterval, true);
+	}
+	else
+	{
+		SetComponentTickEnabled(true);
+	}
 }
 
 void UTPInputRecordingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	InputData.Bindings.Add(MakeBindingsData());
+	RecordInputData();
 }
 
-FBindingsData UTPInputRecordingComponent::MakeBindingsData() const
+void UTPInputRecordingComponent::RecordInputData()
 {
-	FBindingsData BindingsData;
-	BindingsData.WorldTime = GetWorld()->TimeSeconds;
-	for (int32 i = 0; i < InputComp->GetActionEventBindings().Num(); ++i)
-	{
-		FEnhancedInputActionEventBinding* Action = InputComp->GetActionEventBindings()[i].Get();
-		const FName CurrentActionName = FName{Action->GetAction()->GetName()};
+	if (!Writer.IsOpen()) return;
+
+	const double WorldTime = GetWorld()->TimeSeconds;
+	if (WorldTime == LastRecordedTime) return;
+	LastRecordedTime = WorldTime;
 
-		FAxisData CurrentAxisData{};
-		CurrentAxisData.Name = CurrentActionName;
-		CurrentAxisData.Value = InputComp->BindActionValue(Action->GetAction()).GetValue().Get<FVector2D>();
-		BindingsData.AxisValues.Add(CurrentAxisData);
+	uint8* Record = Writer.AcquireRecord();
+	InputLayout.WorldTime(Record) = WorldTime;
+
+	const TArray<FEnhancedInputActionValueBinding>& ValueBindings = InputComp->GetActionValueBindings();
+	FRecordingInputChange* Changes = InputLayout.Changes(Record);
+	int32 NumChanges = 0;
+	for (int32 Slot = 0; Slot < SlotValueBindings.Num(); ++Slot)
+	{
+		const FVector2D Value = ValueBindings[SlotValueBindings[Slot]].GetValue().Get<FVector2D>();
+		if (Value != LastSlotValues[Slot])
+		{
+			LastSlotValues[Slot] = Value;
+			Changes[NumChanges++] = {Slot, Value};
+		}
 	}
+	InputLayout.NumChanges(Record) = NumChanges;
 
-	return BindingsData;
+	Writer.CommitRecord();
 }
 
 FString UTPInputRecordingComponent::GenerateFileName() const
 {
-	return FPaths::GameSourceDir().Append("TestProject/Tests/Data/CharacterTestInput.json");
+	return FPaths::GameSourceDir().Append("TestProject/Tests/Data/CharacterTestInput.tprec");
 }
 
 void UTPInputRecordingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
-	JsonUtils::WriteInputData(GenerateFileName(), InputData);
+
+	GetWorld()->GetTimerManager().ClearTimer(InputRecordTimer);
+	if (!Writer.Finalize()) return;
+
+	// Gameplay tests replay the JSON recordings, which only keep the value transitions. Converted off the game thread
+	WaitForConversion();
+	PendingConversion = Async(EAsyncExecution::TaskGraph, [FileName = GenerateFileName()]()
+		{
+			const FString JsonFileName = FPaths::ChangeExtension(FileName, TEXT("json"));
+			if (RecordingBinaryUtils::ConvertBinaryToJson(FileName, JsonFileName)) return true;
+
+			UE_LOG(LogTemp, Error, TEXT("Input recording %s can't be converted to %s"), *FileName, *JsonFileName);
+			return false;
+		});
+
+	// The world is going away, the next test or an editor exit must not see a half written file
+	if (EndPlayReason != EEndPlayReason::Destroyed && EndPlayReason != EEndPlayReason::RemovedFromWorld)
+	{
+		WaitForConversion();
+	}
+}
+
+void UTPInputRecordingComponent::BeginDestroy()
+{
+	WaitForConversion();
+
+	Super::BeginDestroy();
+}
+
+void UTPInputRecordingComponent::WaitForConversion()
+{
+	check(IsInGameThread());
+	if (PendingConversion.IsValid())
+	{
+		PendingConversion.Wait();
+		PendingConversion.Reset();
+	}
 }
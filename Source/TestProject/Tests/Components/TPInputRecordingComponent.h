@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "TestProject/Tests/Utils/InputRecordingUtils.h"
+#include "TestProject/Tests/Utils/RecordingStreamWriter.h"
 #include "TPInputRecordingComponent.generated.h"
 
 
@@ -19,6 +20,15 @@ public:
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void BeginDestroy() override;
+
+	// Samples kept in memory before the writer thread flushes them to disk
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "8"))
+	int32 BufferCapacity{ 1024 };
+
+	// Zero records every frame
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", Units = "s"))
+	float SampleInterval{ 1.0f / 60.0f };
 
 public:	
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -28,8 +38,18 @@ private:
 	UEnhancedInputComponent* InputComp;
 	UPlayerInput* PlayerInput;
 
-	FInputData InputData;
+	// Index in InputComp->GetActionValueBindings() for every recorded slot, bound once in BeginPlay
+	TArray<int32> SlotValueBindings;
+	TArray<FVector2D> LastSlotValues;
+	// A looping timer can fire several times in one slow frame, those calls would only repeat this sample
+	double LastRecordedTime{ -1.0 };
+	FRecordingInputLayout InputLayout;
+	FTimerHandle InputRecordTimer;
+
+	TestProject::FRecordingStreamWriter Writer;
 
-	FBindingsData MakeBindingsData() const;
+	void RecordInputData();
 	FString GenerateFileName() const;
+	// Waits for the JSON conversion of the last finished recording, of any recorder
+	static void WaitForConversion();
 };
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#if (WITH_DEV_AUTOMATION_TESTS || WITH_PERF_AUTOMATION_TESTS)
+
+#include "Tests/PoseComparisonTests.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Tests/TestUtils.h"
+#include "Utils/PoseComparison.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseComparisonKernel, "TestProject.Recording.PoseComparison.Kernel",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseComparisonReportStats, "TestProject.Recording.PoseComparison.Report",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseComparisonCursor, "TestProject.Recording.PoseComparison.Cursor",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+using namespace TestProject;
+
+namespace
+{
+	// Not a multiple of the SIMD width, so the padded tail is exercised too
+	constexpr int32 NumBones = 89;
+
+	FPoseSoA MakeRandomPose(FRandomStream& Random, TArray<FVector>& OutPositions, TArray<FQuat>& OutRotations)
+	{
+		FPoseSoA Pose;
+		Pose.SetNumBones(NumBones);
+		OutPositions.SetNum(NumBones);
+		OutRotations.SetNum(NumBones);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			OutPositions[BoneIndex] = Random.GetUnitVector() * Random.FRandRange(0.0f, 500.0f);
+			OutRotations[BoneIndex] = FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI));
+			Pose.SetBone(BoneIndex, OutPositions[BoneIndex], OutRotations[BoneIndex]);
+		}
+		return Pose;
+	}
+
+	TArray<FName> MakeBoneNames()
+	{
+		TArray<FName> BoneNames;
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			BoneNames.Add(FName("Bone", NAME_EXTERNAL_TO_INTERNAL(BoneIndex)));
+		}
+		return BoneNames;
+	}
+}
+
+bool FPoseComparisonKernel::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(42);
+	TArray<FVector> ExpectedPositions, ActualPositions;
+	TArray<FQuat> ExpectedRotations, ActualRotations;
+	const FPoseSoA Expected = MakeRandomPose(Random, ExpectedPositions, ExpectedRotations);
+	const FPoseSoA Actual = MakeRandomPose(Random, ActualPositions, ActualRotations);
+
+	TArray<float> PositionErrors, RotationErrors;
+	FPoseComparisonReport::ComparePoses(Expected, Actual, PositionErrors, RotationErrors);
+	TestTrueExpr(PositionErrors.Num() % FPoseSoA::Lanes == 0);
+	TestTrueExpr(PositionErrors.Num() >= NumBones);
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		// Scalar reference of the FVector::Equals / FRotator::Equals rule
+		const FVector PositionDelta = (ExpectedPositions[BoneIndex] - ActualPositions[BoneIndex]).GetAbs();
+		const FRotator RotationDelta = (ExpectedRotations[BoneIndex].Rotator() - ActualRotations[BoneIndex].Rotator()).GetNormalized();
+		const double ExpectedPositionError = PositionDelta.GetMax();
+		const double ExpectedRotationError = FMath::Max3(FMath::Abs(RotationDelta.Pitch), FMath::Abs(RotationDelta.Yaw), FMath::Abs(RotationDelta.Roll));
+		if (!TestTrueExpr(FMath::IsNearlyEqual(PositionErrors[BoneIndex], ExpectedPositionError, 1e-3))) return false;
+		if (!TestTrueExpr(FMath::IsNearlyEqual(RotationErrors[BoneIndex], ExpectedRotationError, 1e-2))) return false;
+	}
+
+	return true;
+}
+
+bool FPoseComparisonReportStats::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(7);
+	TArray<FVector> Positions;
+	TArray<FQuat> Rotations;
+	const FPoseSoA Expected = MakeRandomPose(Random, Positions, Rotations);
+
+	// Bone 3 drifts 40 units, bone 70 turns 45 degrees, everything else stays within tolerance.
+	// Bone 20 is 34.6 units away but only 20 along each axis, which passes the per-axis rule.
+	FPoseSoA Actual = Expected;
+	Actual.SetBone(3, Positions[3] + FVector(0.0, 40.0, 0.0), Rotations[3]);
+	Actual.SetBone(70, Positions[70], FQuat(FVector::UpVector, FMath::DegreesToRadians(45.0)) * Rotations[70]);
+	Actual.SetBone(10, Positions[10] + FVector(5.0, 0.0, 0.0), Rotations[10]);
+	Actual.SetBone(20, Positions[20] + FVector(20.0, 20.0, 20.0), Rotations[20]);
+
+	FPoseComparisonReport Report(MakeBoneNames(), 30.0f, 30.0f, 3);
+	for (int32 Frame = 0; Frame < 4; ++Frame)
+	{
+		Report.AddFrame(Expected, Actual);
+	}
+
+	TestTrueExpr(Report.GetNumFrames() == 4);
+	TestTrueExpr(Report.GetNumMismatches() == 8);
+	// Only the first mismatches are stored
+	TestTrueExpr(Report.GetMismatches().Num() == 3);
+	TestTrueExpr(Report.GetMismatches()[0].Frame == 0 && Report.GetMismatches()[0].BoneIndex == 3);
+	TestTrueExpr(Report.GetMismatches()[1].Frame == 0 && Report.GetMismatches()[1].BoneIndex == 70);
+
+	const TArray<FBoneErrorStats>& BoneStats = Report.GetBoneStats();
+	TestTrueExpr(FMath::IsNearlyEqual(BoneStats[3].MaxPositionError, 40.0f, 1e-2f));
+	TestTrueExpr(FMath::IsNearlyEqual(BoneStats[70].MaxRotationError, 45.0f, 1e-1f));
+	TestTrueExpr(BoneStats[10].NumMismatches == 0);
+	TestTrueExpr(FMath::IsNearlyEqual(BoneStats[10].MaxPositionError, 5.0f, 1e-2f));
+	TestTrueExpr(BoneStats[20].NumMismatches == 0);
+	TestTrueExpr(FMath::IsNearlyEqual(BoneStats[20].MaxPositionError, 20.0f, 1e-2f));
+	TestTrueExpr(Report.ToString().Contains("Bone_3") && Report.ToString().Contains("Bone_70"));
+
+	return true;
+}
+
+bool FPoseComparisonCursor::RunTest(const FString& Parameters)
+{
+	FRecordingAnimationData AnimationData;
+	for (const float Time : { 1.0f, 2.0f, 4.0f })
+	{
+		FRecordingSkeletonData& SkeletonData = AnimationData.SkeletonRecordings.AddDefaulted_GetRef();
+		SkeletonData.WorldTime = Time;
+		FRecordingBoneData& BoneData = SkeletonData.BoneValues.AddDefaulted_GetRef();
+		BoneData.Name = "Root";
+		BoneData.Position = FVector(Time * 10.0f, 0.0, 0.0);
+		BoneData.Rotation = FRotator(0.0, Time * 10.0f, 0.0);
+	}
+
+	FRecordedPoseCursor Cursor(AnimationData);
+	TestTrueExpr(Cursor.GetStartTime() == 1.0f);
+	TestTrueExpr(Cursor.GetEndTime() == 4.0f);
+
+	const TArray<TestPayload<float, float>> TestData
+	{
+		{ 0.5f, 10.0f },
+		{ 1.5f, 15.0f },
+		{ 3.0f, 30.0f },
+		{ 4.0f, 40.0f },
+		{ 1.25f, 12.5f },
+		{ 5.0f, 40.0f }
+	};
+
+	FPoseSoA Pose;
+	for (const auto& Data : TestData)
+	{
+		Cursor.Sample(Data.TestValue, Pose);
+		TestTrueExpr(FMath::IsNearlyEqual(Pose.PositionX[0], Data.ExpectedValue, 1e-3f));
+		TestTrueExpr(FMath::IsNearlyEqual(Pose.RotationYaw[0], Data.ExpectedValue, 1e-2f));
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
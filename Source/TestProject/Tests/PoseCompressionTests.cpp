@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#if WITH_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/PoseCompressionTests.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Tests/TestUtils.h"
+#include "Utils/JsonUtils.h"
+#include "Utils/PoseCompression.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseCompressionErrorIsBounded, "TestProject.Recording.PoseCompression.ErrorIsBounded",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseCompressionRejectsInvalidSettings, "TestProject.Recording.PoseCompression.RejectsInvalidSettings",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseCompressionRatio, "TestProject.Recording.PoseCompression.Ratio",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+using namespace TestProject;
+
+namespace
+{
+	// Tolerance used by FCompareAnimationToSavedData
+	constexpr double ComparisonTolerance = 30.0;
+
+	// Rotator components are only guaranteed to stay within tolerance up to this pitch
+	constexpr double GuaranteedPitch = 80.0;
+
+	const FString AnimationDataPath = FPaths::GameSourceDir().Append("TestProject/Tests/Data/AnimationTestData.json");
+}
+
+bool FPoseCompressionErrorIsBounded::RunTest(const FString& Parameters)
+{
+	FRecordingAnimationData AnimationData;
+	if (!TestTrue("Animation data is read", JsonUtils::ReadSkeletonData(AnimationDataPath, AnimationData))) return false;
+
+	const TArray<TestPayload<FPoseCompressionSettings, FString>> TestData
+	{
+		{ FPoseCompressionSettings{}, "default" },
+		{ { 0.01, 16, 10 }, "fine" },
+		{ { 2.0, 10, 1000 }, "coarse" }
+	};
+
+	for (const auto& Data : TestData)
+	{
+		const FPoseCompressionSettings& Settings = Data.TestValue;
+		AddInfo(FString::Printf(TEXT("Settings %s: max position error %f, max rotation error %f deg"),
+			*Data.ExpectedValue, Settings.GetMaxPositionError(), Settings.GetMaxRotationError()));
+
+		TestTrue("Position bound is below comparison tolerance", Settings.GetMaxPositionError() < ComparisonTolerance);
+		TestTrue("Rotation bound is below comparison tolerance", Settings.GetMaxRotationError() < ComparisonTolerance);
+		TestTrue("Rotator bound is below comparison tolerance", Settings.GetMaxRotatorError(GuaranteedPitch) < ComparisonTolerance);
+
+		FCompressedAnimationData Compressed;
+		if (!TestTrue("Data is compressed", PoseCompression::Compress(AnimationData, Settings, Compressed))) return false;
+
+		FRecordingAnimationData Restored;
+		if (!TestTrue("Data is decompressed", PoseCompression::Decompress(Compressed, Restored))) return false;
+		if (!TestEqual("Frame count", Restored.SkeletonRecordings.Num(), AnimationData.SkeletonRecordings.Num())) return false;
+
+		double MaxPositionError = 0.0;
+		double MaxRotationError = 0.0;
+		double MaxRotatorError = 0.0;
+		for (int32 FrameIndex = 0; FrameIndex < AnimationData.SkeletonRecordings.Num(); ++FrameIndex)
+		{
+			const FRecordingSkeletonData& Original = AnimationData.SkeletonRecordings[FrameIndex];
+			const FRecordingSkeletonData& Frame = Restored.SkeletonRecordings[FrameIndex];
+			if (!TestTrueExpr(Frame.WorldTime == Original.WorldTime)) return false;
+			if (!TestTrueExpr(Frame.BoneValues.Num() == Original.BoneValues.Num())) return false;
+
+			for (int32 BoneIndex = 0; BoneIndex < Original.BoneValues.Num(); ++BoneIndex)
+			{
+				const FRecordingBoneData& OriginalBone = Original.BoneValues[BoneIndex];
+				const FRecordingBoneData& Bone = Frame.BoneValues[BoneIndex];
+				if (!TestTrueExpr(Bone.Name == OriginalBone.Name)) return false;
+
+				MaxPositionError = FMath::Max(MaxPositionError, (Bone.Position - OriginalBone.Position).GetAbsMax());
+				MaxRotationError = FMath::Max(MaxRotationError,
+					FMath::RadiansToDegrees(Bone.Rotation.Quaternion().AngularDistance(OriginalBone.Rotation.Quaternion())));
+
+				const FRotator RotatorDelta = (Bone.Rotation - OriginalBone.Rotation).GetNormalized();
+				const double RotatorError = FMath::Max3(FMath::Abs(RotatorDelta.Pitch), FMath::Abs(RotatorDelta.Yaw), FMath::Abs(RotatorDelta.Roll));
+				MaxRotatorError = FMath::Max(MaxRotatorError, RotatorError);
+				if (!TestTrueExpr(RotatorError <= Settings.GetMaxRotatorError(OriginalBone.Rotation.Pitch))) return false;
+
+				TestTrueExpr(Bone.Position.Equals(OriginalBone.Position, ComparisonTolerance));
+				TestTrueExpr(Bone.Rotation.Equals(OriginalBone.Rotation, ComparisonTolerance));
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("Measured max position error %f, max rotation error %f deg, max rotator component error %f deg"),
+			MaxPositionError, MaxRotationError, MaxRotatorError));
+		TestTrue("Position error is within the bound", MaxPositionError <= Settings.GetMaxPositionError());
+		TestTrue("Rotation error is within the bound", MaxRotationError <= Settings.GetMaxRotationError());
+	}
+
+	return true;
+}
+
+bool FPoseCompressionRejectsInvalidSettings::RunTest(const FString& Parameters)
+{
+	FRecordingAnimationData AnimationData;
+	if (!TestTrue("Animation data is read", JsonUtils::ReadSkeletonData(AnimationDataPath, AnimationData))) return false;
+
+	FCompressedAnimationData Compressed;
+	if (!TestTrue("Data is compressed", PoseCompression::Compress(AnimationData, FPoseCompressionSettings{}, Compressed))) return false;
+
+	// Settings as a corrupt file could carry them, decoding must fail instead of dividing by zero or over-shifting
+	const TArray<FPoseCompressionSettings> InvalidSettings
+	{
+		{ 0.1, 12, 0 },
+		{ 0.1, 31, 30 },
+		{ 0.1, -1, 30 },
+		{ 0.0, 12, 30 }
+	};
+
+	// Decompress and ReadCompressedData both report every invalid case
+	AddExpectedError("Invalid pose compression settings", EAutomationExpectedErrorFlags::Contains, InvalidSettings.Num() * 2);
+	for (const FPoseCompressionSettings& Settings : InvalidSettings)
+	{
+		TestFalse("Settings are invalid", Settings.IsValid());
+
+		FCompressedAnimationData Corrupt = Compressed;
+		Corrupt.Settings = Settings;
+		FRecordingAnimationData Restored;
+		TestFalse("Corrupt data is not decompressed", PoseCompression::Decompress(Corrupt, Restored));
+
+		const FString CorruptPath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("CorruptAnimationTestData.tppz"));
+		if (!TestTrue("Corrupt data is written", PoseCompression::WriteCompressedData(CorruptPath, Corrupt))) return false;
+
+		FCompressedAnimationData ReadBack;
+		TestFalse("Corrupt file is rejected", PoseCompression::ReadCompressedData(CorruptPath, ReadBack));
+	}
+
+	return true;
+}
+
+bool FPoseCompressionRatio::RunTest(const FString& Parameters)
+{
+	FRecordingAnimationData AnimationData;
+	if (!TestTrue("Animation data is read", JsonUtils::ReadSkeletonData(AnimationDataPath, AnimationData))) return false;
+
+	FCompressedAnimationData Compressed;
+	if (!TestTrue("Data is compressed", PoseCompression::Compress(AnimationData, FPoseCompressionSettings{}, Compressed))) return false;
+
+	const FString CompressedPath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("AnimationTestData.tppz"));
+	if (!TestTrue("Compressed data is written", PoseCompression::WriteCompressedData(CompressedPath, Compressed))) return false;
+
+	FCompressedAnimationData ReadBack;
+	if (!TestTrue("Compressed data is read", PoseCompression::ReadCompressedData(CompressedPath, ReadBack))) return false;
+	TestTrueExpr(ReadBack.Stream == Compressed.Stream);
+	TestTrueExpr(ReadBack.BoneNames == Compressed.BoneNames);
+	TestTrueExpr(ReadBack.WorldTimes == Compressed.WorldTimes);
+
+	const int64 JsonSize = IFileManager::Get().FileSize(*AnimationDataPath);
+	const int64 CompressedSize = IFileManager::Get().FileSize(*CompressedPath);
+	AddInfo(FString::Printf(TEXT("JSON %lld bytes, compressed %lld bytes"), JsonSize, CompressedSize));
+	TestTrue("Compressed file is at least 10x smaller", CompressedSize * 10 <= JsonSize);
+
+	return true;
+}
+
+#endif
\ No newline at end of file
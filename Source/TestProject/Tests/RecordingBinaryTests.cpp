@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#if WITH_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/RecordingBinaryTests.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Tests/TestUtils.h"
+#include "Utils/JsonUtils.h"
+#include "Utils/RecordingBinaryUtils.h"
+#include "Utils/BenchmarkUtils.h"
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FRecordingBinaryRoundTrip, "TestProject.Recording.BinaryRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRecordingBinaryRejectsCorruptHeaders, "TestProject.Recording.BinaryRejectsCorruptHeaders",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_BENCHMARK_TEST(FRecordingReadBenchmark, "TestProject.Recording.ReadBenchmark");
+
+using namespace TestProject;
+
+namespace
+{
+	bool TransformsAreIdentical(const FTransform& A, const FTransform& B)
+	{
+		return A.GetRotation() == B.GetRotation() && A.GetTranslation() == B.GetTranslation() && A.GetScale3D() == B.GetScale3D();
+	}
+}
+
+void FRecordingBinaryRoundTrip::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const TArray<FString> DataFiles =
+	{
+		"AnimationTestData.json",
+		"CharacterTestInput.json",
+		"ItemTestMoveData.json",
+		"ParkourCustomMapMoveData.json",
+		"ParkourTestMoveData.json",
+		"TimeSyncTest.json"
+	};
+
+	for (const FString& DataFile : DataFiles)
+	{
+		OutBeautifiedNames.Add(FPaths::GetBaseFilename(DataFile));
+		OutTestCommands.Add(FPaths::GameSourceDir().Append("TestProject/Tests/Data/").Append(DataFile));
+	}
+}
+
+bool FRecordingBinaryRoundTrip::RunTest(const FString& Parameters)
+{
+	const FString JsonFileName = Parameters;
+	const FString BinaryFileName = FPaths::Combine(FPaths::AutomationTransientDir(), FPaths::GetBaseFilename(JsonFileName) + TEXT(".tprec"));
+	const FString RestoredJsonFileName = FPaths::Combine(FPaths::AutomationTransientDir(), FPaths::GetBaseFilename(JsonFileName) + TEXT(".json"));
+
+	if (!TestTrue("JSON recording is converted to binary", RecordingBinaryUtils::ConvertJsonToBinary(JsonFileName, BinaryFileName))) return false;
+	if (!TestTrue("Binary recording is converted back to JSON", RecordingBinaryUtils::ConvertBinaryToJson(BinaryFileName, RestoredJsonFileName))) return false;
+
+	TestTrue("Binary file is smaller than JSON", IFileManager::Get().FileSize(*BinaryFileName) < IFileManager::Get().FileSize(*JsonFileName));
+
+	if (FPaths::GetBaseFilename(JsonFileName).Equals("AnimationTestData"))
+	{
+		FRecordingAnimationData Expected, Binary, Restored;
+		if (!TestTrue("JSON is read", JsonUtils::ReadSkeletonData(JsonFileName, Expected))) return false;
+		if (!TestTrue("Binary is read", RecordingBinaryUtils::ReadSkeletonData(BinaryFileName, Binary))) return false;
+		if (!TestTrue("Restored JSON is read", JsonUtils::ReadSkeletonData(RestoredJsonFileName, Restored))) return false;
+
+		for (const FRecordingAnimationData* Actual : { &Binary, &Restored })
+		{
+			TestTrueExpr(TransformsAreIdentical(Actual->InitialTransform, Expected.InitialTransform));
+			if (!TestEqual("Frame count", Actual->SkeletonRecordings.Num(), Expected.SkeletonRecordings.Num())) return false;
+
+			for (int32 FrameIndex = 0; FrameIndex < Expected.SkeletonRecordings.Num(); ++FrameIndex)
+			{
+				const FRecordingSkeletonData& ExpectedFrame = Expected.SkeletonRecordings[FrameIndex];
+				const FRecordingSkeletonData& ActualFrame = Actual->SkeletonRecordings[FrameIndex];
+				if (!TestTrueExpr(ActualFrame.WorldTime == ExpectedFrame.WorldTime)) return false;
+				if (!TestTrueExpr(ActualFrame.BoneValues.Num() == ExpectedFrame.BoneValues.Num())) return false;
+
+				for (int32 BoneIndex = 0; BoneIndex < ExpectedFrame.BoneValues.Num(); ++BoneIndex)
+				{
+					const FRecordingBoneData& ExpectedBone = ExpectedFrame.BoneValues[BoneIndex];
+					const FRecordingBoneData& ActualBone = ActualFrame.BoneValues[BoneIndex];
+					if (!TestTrueExpr(ActualBone.Name == ExpectedBone.Name)) return false;
+					if (!TestTrueExpr(ActualBone.Position == ExpectedBone.Position)) return false;
+					if (!TestTrueExpr(ActualBone.Rotation == ExpectedBone.Rotation)) return false;
+				}
+			}
+		}
+	}
+	else
+	{
+		FInputData Expected, Binary, Restored;
+		if (!TestTrue("JSON is read", JsonUtils::ReadInputData(JsonFileName, Expected))) return false;
+		if (!TestTrue("Binary is read", RecordingBinaryUtils::ReadInputData(BinaryFileName, Binary))) return false;
+		if (!TestTrue("Restored JSON is read", JsonUtils::ReadInputData(RestoredJsonFileName, Restored))) return false;
+
+		for (const FInputData* Actual : { &Binary, &Restored })
+		{
+			TestTrueExpr(TransformsAreIdentical(Actual->InitialTransform, Expected.InitialTransform));
+			if (!TestEqual("Frame count", Actual->Bindings.Num(), Expected.Bindings.Num())) return false;
+
+			for (int32 FrameIndex = 0; FrameIndex < Expected.Bindings.Num(); ++FrameIndex)
+			{
+				const FBindingsData& ExpectedFrame = Expected.Bindings[FrameIndex];
+				const FBindingsData& ActualFrame = Actual->Bindings[FrameIndex];
+				if (!TestTrueExpr(ActualFrame.WorldTime == ExpectedFrame.WorldTime)) return false;
+				if (!TestTrueExpr(ActualFrame.AxisValues.Num() == ExpectedFrame.AxisValues.Num())) return false;
+
+				for (int32 AxisIndex = 0; AxisIndex < ExpectedFrame.AxisValues.Num(); ++AxisIndex)
+				{
+					if (!TestTrueExpr(ActualFrame.AxisValues[AxisIndex].Name == ExpectedFrame.AxisValues[AxisIndex].Name)) return false;
+					if (!TestTrueExpr(ActualFrame.AxisValues[AxisIndex].Value == ExpectedFrame.AxisValues[AxisIndex].Value)) return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FRecordingBinaryRejectsCorruptHeaders::RunTest(const FString& Parameters)
+{
+	const FString JsonFileName = FPaths::GameSourceDir().Append("TestProject/Tests/Data/CharacterTestInput.json");
+	const FString BinaryFileName = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("CorruptHeader.tprec"));
+	if (!TestTrue("JSON recording is converted to binary", RecordingBinaryUtils::ConvertJsonToBinary(JsonFileName, BinaryFileName))) return false;
+
+	TArray<uint8> Original;
+	if (!TestTrue("Binary recording is loaded", FFileHelper::LoadFileToArray(Original, *BinaryFileName))) return false;
+	const FRecordingFileHeader ValidHeader = *reinterpret_cast<const FRecordingFileHeader*>(Original.GetData());
+
+	FMappedRecording Recording;
+	if (!TestTrue("Valid recording is opened", Recording.Open(BinaryFileName))) return false;
+	Recording.Close();
+
+	// Tables out of order, a name count the name table can't hold, a frame block past the end of the file
+	// and one whose end wraps around uint64
+	const TArray<TFunction<void(FRecordingFileHeader&)>> Corruptions
+	{
+		[](FRecordingFileHeader& Header) { Header.NameTableOffset = 0; },
+		[](FRecordingFileHeader& Header) { Header.NameTableOffset = Header.SlotTableOffset + 8; },
+		[](FRecordingFileHeader& Header) { Header.SlotTableOffset = Header.FramesOffset + 8; },
+		[](FRecordingFileHeader& Header) { Header.NumFrames = MAX_uint32; },
+		[](FRecordingFileHeader& Header) { Header.NumNames = MAX_int32; },
+		[](FRecordingFileHeader& Header)
+		{
+			// FramesOffset + NumFrames * FrameStride is 0 after wrapping
+			Header.FramesOffset = 0 - static_cast<uint64>(Header.FrameStride);
+			Header.NumFrames = 1;
+		}
+	};
+
+	AddExpectedError("is not a valid recording file", EAutomationExpectedErrorFlags::Contains, Corruptions.Num());
+	for (const TFunction<void(FRecordingFileHeader&)>& Corrupt : Corruptions)
+	{
+		TArray<uint8> Bytes = Original;
+		FRecordingFileHeader Header = ValidHeader;
+		Corrupt(Header);
+		FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(FRecordingFileHeader));
+		if (!TestTrue("Corrupt recording is written", FFileHelper::SaveArrayToFile(Bytes, *BinaryFileName))) return false;
+
+		TestFalse("Corrupt recording is rejected", Recording.Open(BinaryFileName));
+		Recording.Close();
+	}
+
+	return true;
+}
+
+bool FRecordingReadBenchmark::RunTest(const FString& Parameters)
+{
+	const FString JsonFileName = FPaths::GameSourceDir().Append("TestProject/Tests/Data/ParkourTestMoveData.json");
+	const FString BinaryFileName = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ParkourTestMoveData.tprec"));
+	if (!TestTrue("JSON recording is converted to binary", RecordingBinaryUtils::ConvertJsonToBinary(JsonFileName, BinaryFileName))) return false;
+
+	// File reads are milliseconds, fewer samples keep the test short
+	FBenchmarkScope Benchmark(*this, { 0.1, 0.01, 21 });
+
+	Benchmark.Run("JsonUtils::ReadInputData", [&JsonFileName]()
+		{
+			FInputData InputData;
+			DoNotOptimize(JsonUtils::ReadInputData(JsonFileName, InputData));
+		});
+	Benchmark.Run("RecordingBinaryUtils::ReadInputData", [&BinaryFileName]()
+		{
+			FInputData InputData;
+			DoNotOptimize(RecordingBinaryUtils::ReadInputData(BinaryFileName, InputData));
+		});
+
+	FInputData InputData;
+	if (!TestTrue("JSON is read", JsonUtils::ReadInputData(JsonFileName, InputData))) return false;
+	const FString WrittenFileName = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ParkourTestMoveDataBenchmark.json"));
+	Benchmark.Run("JsonUtils::WriteInputData", [&WrittenFileName, &InputData]()
+		{
+			DoNotOptimize(JsonUtils::WriteInputData(WrittenFileName, InputData));
+		});
+
+	return true;
+}
+
+#endif
\ No newline at end of file
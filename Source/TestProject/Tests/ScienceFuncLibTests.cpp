@@ -6,7 +6,10 @@
 #include "CoreMinimal.h"
 #include "Tests/TestUtils.h"
 #include "Misc/AutomationTest.h"
+#include "Algo/Count.h"
 #include "Science/ScienceFuncLib.h"
+#include "Science/BigInteger.h"
+#include "Utils/BenchmarkUtils.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFibonacciSimple, "TestProject.Science.Fibonacci.Simple",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
@@ -14,6 +17,19 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFibonacciSimple, "TestProject.Science.Fibonacc
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFibonacciStress, "TestProject.Science.Fibonacci.Stress",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::StressFilter | EAutomationTestFlags::LowPriority);
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFibonacciOverflowIsReported, "TestProject.Science.Fibonacci.OverflowIsReported",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScienceBatchMatchesSingleCalls, "TestProject.Science.Batch.MatchesSingleCalls",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScienceBigValues, "TestProject.Science.Big.Values",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_BENCHMARK_TEST(FScienceBenchmark, "TestProject.Science.Benchmark");
+
+IMPLEMENT_BENCHMARK_TEST(FScienceBigBenchmark, "TestProject.Science.Big.Benchmark");
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFibonacciLogHasErrors, "TestProject.Science.Fibonacci.LogHasErrors",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
 
@@ -47,7 +63,7 @@ bool FFibonacciStress::RunTest(const FString& Parameters)
 
 	int32 PrevPrevValue = 0;
 	int32 PrevValue = 1;
-	for (int32 i = 2; i < 40; ++i)
+	for (int32 i = 2; i <= UScienceFuncLib::MaxFibonacciInt32; ++i)
 	{
 		const int32 CurrentValue = UScienceFuncLib::Fibonacci(i);
 
@@ -56,6 +72,159 @@ bool FFibonacciStress::RunTest(const FString& Parameters)
 		PrevValue = CurrentValue;
 	}
 
+	int64 PrevPrevValue64 = 0;
+	int64 PrevValue64 = 1;
+	for (int32 i = 2; i <= UScienceFuncLib::MaxFibonacciInt64; ++i)
+	{
+		const int64 CurrentValue = UScienceFuncLib::Fibonacci64(i);
+
+		TestTrueExpr(CurrentValue == PrevValue64 + PrevPrevValue64);
+		PrevPrevValue64 = PrevValue64;
+		PrevValue64 = CurrentValue;
+	}
+
+	return true;
+}
+
+bool FFibonacciOverflowIsReported::RunTest(const FString& Parameters)
+{
+	AddInfo("Fibonacci numbers that don't fit the return type produce error");
+
+	TestTrueExpr(UScienceFuncLib::Fibonacci(46) == 1836311903);
+	TestTrueExpr(UScienceFuncLib::Fibonacci64(92) == 7540113804746346429);
+
+	AddExpectedError("overflows int32", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::Fibonacci(UScienceFuncLib::MaxFibonacciInt32 + 1) == -1);
+
+	AddExpectedError("overflows int64", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::Fibonacci64(UScienceFuncLib::MaxFibonacciInt64 + 1) == -1);
+
+	return true;
+}
+
+bool FScienceBatchMatchesSingleCalls::RunTest(const FString& Parameters)
+{
+	AddInfo("Batch functions return the same values as single calls");
+
+	// Big enough to be split into several parallel chunks
+	TArray<int32> Values;
+	for (int32 i = 0; i < 20000; ++i)
+	{
+		Values.Add(i % (UScienceFuncLib::MaxFactorialInt32 + 1));
+	}
+
+	const TArray<int32> Fibonacci = UScienceFuncLib::FibonacciBatch(Values);
+	const TArray<int32> Factorial = UScienceFuncLib::FactorialBatch(Values);
+	if (!TestEqual("Fibonacci result count", Fibonacci.Num(), Values.Num())) return false;
+	if (!TestEqual("Factorial result count", Factorial.Num(), Values.Num())) return false;
+
+	for (int32 i = 0; i < Values.Num(); ++i)
+	{
+		if (!TestTrueExpr(Fibonacci[i] == UScienceFuncLib::Fibonacci(Values[i]))) return false;
+		if (!TestTrueExpr(Factorial[i] == UScienceFuncLib::Factorial(Values[i]))) return false;
+	}
+
+	TestTrueExpr(UScienceFuncLib::FibonacciBatch({}).IsEmpty());
+	TestTrueExpr(UScienceFuncLib::FactorialBatch({ -1, 3 }) == TArray<int32>({ -1, 6 }));
+
+	// Every out-of-range value of a batch is reported by one error, not one per element
+	TArray<int32> OverflowingValues;
+	OverflowingValues.Init(UScienceFuncLib::MaxFibonacciInt32 + 1, 10000);
+	OverflowingValues[0] = 3;
+	AddExpectedError("FibonacciBatch: 9999 of 10000 inputs are invalid, first at index 1", EAutomationExpectedErrorFlags::Contains, 1);
+	const TArray<int32> Overflowing = UScienceFuncLib::FibonacciBatch(OverflowingValues);
+	TestTrueExpr(Overflowing[0] == 2);
+	TestTrueExpr(Overflowing.Num() == OverflowingValues.Num() && Algo::Count(Overflowing, -1) == OverflowingValues.Num() - 1);
+
+	return true;
+}
+
+bool FScienceBigValues::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	AddInfo("Big integer values match the int64 functions and known large values");
+
+	for (int32 i = 0; i <= UScienceFuncLib::MaxFibonacciInt64; ++i)
+	{
+		if (!TestEqual(FString::Printf(TEXT("Fibonacci %i"), i), UScienceFuncLib::FibonacciBig(i), LexToString(UScienceFuncLib::Fibonacci64(i)))) return false;
+	}
+	for (int32 i = 0; i <= UScienceFuncLib::MaxFactorialInt64; ++i)
+	{
+		if (!TestEqual(FString::Printf(TEXT("Factorial %i"), i), UScienceFuncLib::FactorialBig(i), LexToString(UScienceFuncLib::Factorial64(i)))) return false;
+	}
+
+	TestEqual("Fibonacci 100", UScienceFuncLib::FibonacciBig(100), FString("354224848179261915075"));
+	TestEqual("Factorial 30", UScienceFuncLib::FactorialBig(30), FString("265252859812191058636308480000000"));
+
+	// Large enough for Karatsuba, checked against the doubling identity F(2n) = F(n) * (2F(n+1) - F(n))
+	const FBigUnsigned Fn = FBigUnsigned::Fibonacci(20000);
+	const FBigUnsigned Fn1 = FBigUnsigned::Fibonacci(20001);
+	TestTrueExpr(FBigUnsigned::Fibonacci(40000) == Fn * (Fn1 + Fn1 - Fn));
+
+	const FString Factorial = UScienceFuncLib::FactorialBig(UScienceFuncLib::MaxFactorialBig);
+	TestEqual("Digits of 100000!", Factorial.Len(), 456574);
+	TestTrueExpr(Factorial.StartsWith("28242294079603478742"));
+
+	AddExpectedError("Invalid input for FactorialBig", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::FactorialBig(-1).IsEmpty());
+
+	// Inputs above the limit are rejected up front instead of freezing the caller
+	AddExpectedError("FactorialBig of 100001 overflows the big integer limit", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::FactorialBig(UScienceFuncLib::MaxFactorialBig + 1).IsEmpty());
+
+	AddExpectedError("FibonacciBig of 1000001 overflows the big integer limit", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::FibonacciBig(UScienceFuncLib::MaxFibonacciBig + 1).IsEmpty());
+
+	AddExpectedError("FactorialBig of 100000000 overflows", EAutomationExpectedErrorFlags::Contains);
+	TestTrueExpr(UScienceFuncLib::FactorialBig(100000000).IsEmpty());
+
+	return true;
+}
+
+bool FScienceBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	FBenchmarkScope Benchmark(*this);
+
+	// Separate counters, a value left over from the Fibonacci run would overflow Factorial and log an error
+	int32 FibonacciValue = 0;
+	Benchmark.Run("Fibonacci", [&FibonacciValue]()
+		{
+			DoNotOptimize(UScienceFuncLib::Fibonacci(FibonacciValue));
+			FibonacciValue = (FibonacciValue + 1) % (UScienceFuncLib::MaxFibonacciInt32 + 1);
+		});
+	int32 FactorialValue = 0;
+	Benchmark.Run("Factorial", [&FactorialValue]()
+		{
+			DoNotOptimize(UScienceFuncLib::Factorial(FactorialValue));
+			FactorialValue = (FactorialValue + 1) % (UScienceFuncLib::MaxFactorialInt32 + 1);
+		});
+
+	TArray<int32> Values;
+	for (int32 i = 0; i < 100000; ++i)
+	{
+		Values.Add(i % (UScienceFuncLib::MaxFactorialInt32 + 1));
+	}
+	Benchmark.Run("FibonacciBatch 100000", [&Values]() { DoNotOptimize(UScienceFuncLib::FibonacciBatch(Values)); });
+	Benchmark.Run("FactorialBatch 100000", [&Values]() { DoNotOptimize(UScienceFuncLib::FactorialBatch(Values)); });
+
+	return true;
+}
+
+bool FScienceBigBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	// Single calls take up to a second, a few samples are enough
+	FBenchmarkScope Benchmark(*this, { 0.0, 0.0, 5 });
+
+	Benchmark.Run("FactorialBig 10000", []() { DoNotOptimize(UScienceFuncLib::FactorialBig(10000)); });
+	Benchmark.Run("FactorialBig 100000", []() { DoNotOptimize(UScienceFuncLib::FactorialBig(100000)); });
+	Benchmark.Run("FibonacciBig 100000", []() { DoNotOptimize(UScienceFuncLib::FibonacciBig(100000)); });
+	Benchmark.Run("FibonacciBig 1000000", []() { DoNotOptimize(UScienceFuncLib::FibonacciBig(UScienceFuncLib::MaxFibonacciBig)); });
+
 	return true;
 }
 
@@ -95,6 +264,25 @@ void FFactorial::Define()
 					[this, Data]() {TestTrueExpr(UScienceFuncLib::Factorial(Data.TestValue) == Data.ExpectedValue); });
 			}
 		});
+	Describe("Overflow",
+		[this]()
+		{
+			It("Factorial of 12 is the last one in int32", [this]() {TestTrueExpr(UScienceFuncLib::Factorial(12) == 479001600); });
+			It("Factorial of 20 is the last one in int64",
+				[this]() {TestTrueExpr(UScienceFuncLib::Factorial64(20) == 2432902008176640000); });
+			It("Factorial of 13 overflows int32 and should return -1",
+				[this]()
+				{
+					AddExpectedError("overflows int32", EAutomationExpectedErrorFlags::Contains);
+					TestTrueExpr(UScienceFuncLib::Factorial(13) == -1);
+				});
+			It("Factorial of 21 overflows int64 and should return -1",
+				[this]()
+				{
+					AddExpectedError("overflows int64", EAutomationExpectedErrorFlags::Contains);
+					TestTrueExpr(UScienceFuncLib::Factorial64(21) == -1);
+				});
+		});
 }
 
 #endif
\ No newline at end of file
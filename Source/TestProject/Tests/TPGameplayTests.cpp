@@ -15,6 +15,7 @@
 #include "EnhancedInputSubsystems.h"
 #include "Utils/JsonUtils.h"
 #include "Utils/InputRecordingUtils.h"
+#include "HAL/IConsoleManager.h"
 
 using namespace TestProject;
 
@@ -36,6 +37,31 @@ IMPLEMENT_COMPLEX_AUTOMATION_TEST(FAllItemsAreTakenOnRecordingMovementComplex, "
 
 namespace
 {
+	TAutoConsoleVariable<float> CVarReplayFixedDeltaTime(TEXT("TestProject.Replay.FixedDeltaTime"), 1.0f / 60.0f,
+		TEXT("Fixed delta time recorded movement is replayed with, as fast as possible. Zero replays in real time."));
+
+	TAutoConsoleVariable<float> CVarReplayTimeDilation(TEXT("TestProject.Replay.TimeDilation"), 1.0f,
+		TEXT("World time dilation used while replaying recorded movement with a fixed delta time."));
+
+	FixedTimeStepScope MakeReplayTimeStepScope(UWorld* World)
+	{
+		return FixedTimeStepScope(World, CVarReplayFixedDeltaTime.GetValueOnGameThread(), CVarReplayTimeDilation.GetValueOnGameThread());
+	}
+
+	/** Waits for the recording and moves the character to where it was recorded. */
+	class FStartReplayLatentCommand : public TWaitForFutureLatentCommand<TSharedPtr<FInputData>>
+	{
+	public:
+		FStartReplayLatentCommand(FAutomationTestBase& Test, TSharedFuture<TSharedPtr<FInputData>> InputData, ACharacter* Character)
+			: TWaitForFutureLatentCommand(MoveTemp(InputData), [&Test, Character](const TSharedPtr<FInputData>& Data)
+				{
+					if (!Test.TestTrue("Recorded input is read", Data.IsValid())) return;
+					Character->SetActorTransform(Data->InitialTransform);
+				})
+		{
+		}
+	};
+
 	const UInputAction* GetActionBindingByIndexName(UEnhancedInputComponent* InputComp, const FString& ActionName)
 	{
 		if (!InputComp) return nullptr;
@@ -53,14 +79,21 @@ namespace
 		return nullptr;
 	}
 
+	/**
+	 * Replays recorded input once its asynchronous load is done. Action names are resolved to indices once and the
+	 * recording is flattened, so every replayed frame is a plain array walk. Recorded transitions update the held values,
+	 * held non-zero values are injected every frame since injected input only lasts for a single tick.
+	 * Unlike the original replay, which injected values only on ticks that reached a recorded sample, this applies to
+	 * old dense recordings too: their values are held between samples instead of being skipped on ticks in between.
+	 */
 	class FSimulateMovementLatentCommand : public IAutomationLatentCommand
 	{
 	public:
-		FSimulateMovementLatentCommand(UWorld* InWorld, UEnhancedInputComponent* EnhancedInputComponent, const TArray<FBindingsData>& InBindingsData, UEnhancedPlayerInput* InPlayerInput)
+		FSimulateMovementLatentCommand(UWorld* InWorld, UEnhancedInputComponent* EnhancedInputComponent, TSharedFuture<TSharedPtr<FInputData>> InInputData, UEnhancedPlayerInput* InPlayerInput)
 			:World(InWorld),
 			 InputComponent(EnhancedInputComponent),
-			 BindingsData(InBindingsData),
-			 PlayerInput(InPlayerInput)
+			 PlayerInput(InPlayerInput),
+			 InputData(MoveTemp(InInputData))
 		{
 
 		}
@@ -69,32 +102,96 @@ namespace
 		{
 			if (!World || !InputComponent) return true;
 
+			if (InputData.IsValid())
+			{
+				if (!InputData.IsReady()) return false;
+				if (const TSharedPtr<FInputData>& Data = InputData.Get())
+				{
+					Flatten(Data->Bindings);
+				}
+				InputData = {};
+			}
+			if (FrameTimes.IsEmpty()) return true;
+
 			if (WorldStartTime == 0.0f)
 			{
 				WorldStartTime = World->TimeSeconds;
 			}
 
-			while (World->TimeSeconds - WorldStartTime >= BindingsData[Index].WorldTime)
+			while (Index < FrameTimes.Num() && World->TimeSeconds - WorldStartTime >= FrameTimes[Index])
 			{
-				for (const auto& AxisValue : BindingsData[Index].AxisValues)
+				for (; TransitionIndex < FrameEnds[Index]; ++TransitionIndex)
 				{
-					const UInputAction* Action = GetActionBindingByIndexName(InputComponent, AxisValue.Name.ToString());
-					if (!Action) return true;
-					FInputActionValue ActionValue(AxisValue.Value);
-					PlayerInput->InjectInputForAction(Action, ActionValue);
+					HeldValues[Transitions[TransitionIndex].ActionIndex] = Transitions[TransitionIndex].Value;
 				}
+				++Index;
+			}
 
-				if (++Index >= BindingsData.Num()) return true;
+			for (int32 ActionIndex = 0; ActionIndex < Actions.Num(); ++ActionIndex)
+			{
+				if (HeldValues[ActionIndex].IsNonZero())
+				{
+					PlayerInput->InjectInputForAction(Actions[ActionIndex], HeldValues[ActionIndex]);
+				}
 			}
-			return false;
+			return Index >= FrameTimes.Num();
 		}
 
 	private:
+		void Flatten(const TArray<FBindingsData>& BindingsData)
+		{
+			TMap<FName, int32> ActionsByName;
+			for (const TUniquePtr<FEnhancedInputActionEventBinding>& EventBinding : InputComponent->GetActionEventBindings())
+			{
+				const FName ActionName{EventBinding->GetAction()->GetName()};
+				if (!ActionsByName.Contains(ActionName))
+				{
+					ActionsByName.Add(ActionName, Actions.Add(EventBinding->GetAction()));
+				}
+			}
+			HeldValues.SetNum(Actions.Num());
+
+			FrameTimes.Reserve(BindingsData.Num());
+			FrameEnds.Reserve(BindingsData.Num());
+			for (const FBindingsData& Frame : BindingsData)
+			{
+				bool bUnknownAction = false;
+				for (const FAxisData& AxisValue : Frame.AxisValues)
+				{
+					const int32* ActionIndex = ActionsByName.Find(AxisValue.Name);
+					if (!ActionIndex)
+					{
+						bUnknownAction = true;
+						break;
+					}
+					Transitions.Add({*ActionIndex, FInputActionValue(AxisValue.Value)});
+				}
+				FrameTimes.Add(Frame.WorldTime);
+				FrameEnds.Add(Transitions.Num());
+
+				// Replay stops at the first unknown action, the known axes listed before it in that frame still apply
+				if (bUnknownAction) return;
+			}
+		}
+
+		struct FTransition
+		{
+			int32 ActionIndex;
+			FInputActionValue Value;
+		};
+
 		const UWorld* World;
 		UEnhancedInputComponent* InputComponent;
 		UEnhancedPlayerInput* PlayerInput;
-		const TArray<FBindingsData> BindingsData;
+		TSharedFuture<TSharedPtr<FInputData>> InputData;
+		TArray<const UInputAction*> Actions;
+		TArray<FInputActionValue> HeldValues;
+		TArray<float> FrameTimes;
+		// One past the last transition of every frame in Transitions
+		TArray<int32> FrameEnds;
+		TArray<FTransition> Transitions;
 		int32 Index{ 0 };
+		int32 TransitionIndex{ 0 };
 		float WorldStartTime{ 0.0f };
 	};
 }
@@ -245,6 +342,10 @@ bool FAllItemsCanBeTakenOnMovement::RunTest(const FString& Parameters)
 
 bool FAllItemsAreTakenOnRecordingMovement::RunTest(const FString& Parameters)
 {
+	// The recording is parsed while the level loads
+	const TSharedFuture<TSharedPtr<FInputData>> InputData = TRecordingSerializer<FInputData>::ReadAsync(
+		FPaths::GameSourceDir().Append("TestProject/Tests/Data/ItemTestMoveData.json")).Share();
+
 	const auto Level = LevelScope("/Game/Tests/InventoryTestLevel3");
 
 	UWorld* World = GetTestGameWorld();
@@ -266,12 +367,10 @@ bool FAllItemsAreTakenOnRecordingMovement::RunTest(const FString& Parameters)
 	UEnhancedPlayerInput* PlayerInput = Subsystem->GetPlayerInput();
 	if (!PlayerInput) return true;
 
-	FInputData InputData;
-	JsonUtils::ReadInputData(FPaths::GameSourceDir().Append("TestProject/Tests/Data/ItemTestMoveData.json"), InputData);
+	const auto TimeStep = MakeReplayTimeStepScope(World);
 
-	Character->SetActorTransform(InputData.InitialTransform);
-	
-	ADD_LATENT_AUTOMATION_COMMAND(FSimulateMovementLatentCommand(World, EnhancedInputComponent, InputData.Bindings, PlayerInput));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartReplayLatentCommand(*this, InputData, Character));
+	ADD_LATENT_AUTOMATION_COMMAND(FSimulateMovementLatentCommand(World, EnhancedInputComponent, InputData, PlayerInput));
 	ADD_LATENT_AUTOMATION_COMMAND(FDelayedFunctionLatentCommand([this, World]()
 		{
 			TArray<AActor*> InventoryItems;
@@ -315,6 +414,8 @@ bool FAllItemsAreTakenOnRecordingMovementComplex::RunTest(const FString& Paramet
 	Parameters.ParseIntoArray(ParsedParams, TEXT(","));
 	if (!TestTrue("Map name and JSON params should exist", ParsedParams.Num() == 2)) return false;
 
+	const TSharedFuture<TSharedPtr<FInputData>> InputData = TRecordingSerializer<FInputData>::ReadAsync(ParsedParams[1]).Share();
+
 	const auto Level = LevelScope(ParsedParams[0]);
 
 	UWorld* World = GetTestGameWorld();
@@ -336,12 +437,10 @@ bool FAllItemsAreTakenOnRecordingMovementComplex::RunTest(const FString& Paramet
 	UEnhancedPlayerInput* PlayerInput = Subsystem->GetPlayerInput();
 	if (!PlayerInput) return true;
 
-	FInputData InputData;
-	JsonUtils::ReadInputData(FPaths::GameSourceDir().Append(ParsedParams[1]), InputData);
-
-	Character->SetActorTransform(InputData.InitialTransform);
+	const auto TimeStep = MakeReplayTimeStepScope(World);
 
-	ADD_LATENT_AUTOMATION_COMMAND(FSimulateMovementLatentCommand(World, EnhancedInputComponent, InputData.Bindings, PlayerInput));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartReplayLatentCommand(*this, InputData, Character));
+	ADD_LATENT_AUTOMATION_COMMAND(FSimulateMovementLatentCommand(World, EnhancedInputComponent, InputData, PlayerInput));
 	ADD_LATENT_AUTOMATION_COMMAND(FDelayedFunctionLatentCommand([this, World]()
 		{
 			TArray<AActor*> InventoryItems;
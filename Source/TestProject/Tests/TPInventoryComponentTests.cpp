@@ -8,6 +8,9 @@
 #include "Tests/TestUtils.h"
 #include "TPTypes.h"
 #include "Components/TPInventoryComponent.h"
+#include "Utils/BenchmarkUtils.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentCouldBeCreated, "TestProject.Components.Inventory.ComponentCouldBeCreated",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
@@ -24,6 +27,17 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPositiveScoreShouldBeAdded, "TestProject.Compo
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScoreMoreThanLimit, "TestProject.Components.Inventory.ScoreMoreThanLimit",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemsAreAddedAllOrNone, "TestProject.Components.Inventory.ItemsAreAddedAllOrNone",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChangesAreCoalesced, "TestProject.Components.Inventory.ChangesAreCoalesced",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConcurrentAddsKeepLimits, "TestProject.Components.Inventory.ConcurrentAddsKeepLimits",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::StressFilter | EAutomationTestFlags::LowPriority);
+
+IMPLEMENT_BENCHMARK_TEST(FInventoryBenchmark, "TestProject.Components.Inventory.Benchmark");
+
 namespace
 {
 	class UTPInventoryComponentTestable : public UTPInventoryComponent
@@ -32,6 +46,7 @@ namespace
 		void SetLimits(const TMap<EInventoryItemType, int32>& Limits)
 		{
 			InventoryLimits = Limits;
+			CacheInventoryLimits();
 		}
 	};
 }
@@ -121,4 +136,180 @@ bool FScoreMoreThanLimit::RunTest(const FString& Parameters)
 	return true;
 }
 
+bool FItemsAreAddedAllOrNone::RunTest(const FString& Parameters)
+{
+	UTPInventoryComponentTestable* InvComp = NewObject<UTPInventoryComponentTestable>();
+	if (!TestNotNull("Inventory component exists", InvComp)) return false;
+
+	InvComp->SetLimits({ {EInventoryItemType::CONE, 100},
+						{EInventoryItemType::CUBE, 100},
+						{EInventoryItemType::CYLINDER, 100},
+						{EInventoryItemType::SPHERE, 100} });
+
+	using Results = TArray<EInventoryAddResult>;
+	Results ItemResults;
+
+	AddInfo("Batch within limits is added");
+	TestTrueExpr(InvComp->TryToAddItems({ { EInventoryItemType::CONE, 40 }, { EInventoryItemType::CUBE, 10 }, { EInventoryItemType::CONE, 50 } }, &ItemResults));
+	TestTrueExpr(ItemResults == Results({ EInventoryAddResult::Added, EInventoryAddResult::Added, EInventoryAddResult::Added }));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CONE) == 90);
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CUBE) == 10);
+
+	AddInfo("Batch total over the limit adds nothing");
+	TestTrueExpr(!InvComp->TryToAddItems({ { EInventoryItemType::CUBE, 20 }, { EInventoryItemType::CONE, 5 }, { EInventoryItemType::CONE, 6 } }, &ItemResults));
+	TestTrueExpr(ItemResults == Results({ EInventoryAddResult::NotCommitted, EInventoryAddResult::NotCommitted, EInventoryAddResult::OverLimit }));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CONE) == 90);
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CUBE) == 10);
+
+	AddInfo("Negative score fails the batch");
+	TestTrueExpr(!InvComp->TryToAddItems({ { EInventoryItemType::SPHERE, -1 }, { EInventoryItemType::SPHERE, 1 } }, &ItemResults));
+	TestTrueExpr(ItemResults == Results({ EInventoryAddResult::NegativeScore, EInventoryAddResult::NotCommitted }));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::SPHERE) == 0);
+
+	AddInfo("Scores summing past int32 don't wrap around the limit");
+	TestTrueExpr(!InvComp->TryToAddItems({ { EInventoryItemType::CYLINDER, MAX_int32 }, { EInventoryItemType::CYLINDER, MAX_int32 } }));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CYLINDER) == 0);
+
+	AddInfo("Empty batch succeeds");
+	TestTrueExpr(InvComp->TryToAddItems({}, &ItemResults));
+	TestTrueExpr(ItemResults.IsEmpty());
+
+	return true;
+}
+
+bool FChangesAreCoalesced::RunTest(const FString& Parameters)
+{
+	UTPInventoryComponentTestable* InvComp = NewObject<UTPInventoryComponentTestable>();
+	if (!TestNotNull("Inventory component exists", InvComp)) return false;
+
+	InvComp->SetLimits({ {EInventoryItemType::CONE, 100},
+						{EInventoryItemType::CUBE, 100},
+						{EInventoryItemType::CYLINDER, 100},
+						{EInventoryItemType::SPHERE, 100} });
+
+	UTPInventoryChangedListener* Listener = NewObject<UTPInventoryChangedListener>();
+	InvComp->OnInventoryChanged.AddDynamic(Listener, &UTPInventoryChangedListener::OnInventoryChanged);
+
+	const auto TypeBit = [](EInventoryItemType Type) { return 1 << static_cast<int32>(Type); };
+
+	AddInfo("Failed and empty adds don't mark anything");
+	TestTrueExpr(!InvComp->TryToAddItem({ EInventoryItemType::CONE, 1000 }));
+	TestTrueExpr(InvComp->TryToAddItem({ EInventoryItemType::CONE, 0 }));
+	TestTrueExpr(InvComp->GetDirtyTypesMask() == 0);
+
+	AddInfo("Several adds collapse into one pending change");
+	TestTrueExpr(InvComp->TryToAddItem({ EInventoryItemType::CONE, 1 }));
+	TestTrueExpr(InvComp->TryToAddItem({ EInventoryItemType::CONE, 2 }));
+	TestTrueExpr(InvComp->TryToAddItems({ { EInventoryItemType::CUBE, 3 }, { EInventoryItemType::CONE, 4 } }));
+	TestTrueExpr(InvComp->GetDirtyTypesMask() == (TypeBit(EInventoryItemType::CONE) | TypeBit(EInventoryItemType::CUBE)));
+	TestTrueExpr(Listener->Broadcasts.Num() == 0);
+
+	AddInfo("Flush broadcasts the combined change once and clears it");
+	InvComp->FlushInventoryChanges();
+	TestTrueExpr(InvComp->GetDirtyTypesMask() == 0);
+	TestTrueExpr(Listener->Broadcasts.Num() == 1);
+	TestTrueExpr(Listener->Broadcasts.Num() == 1 && Listener->Broadcasts[0] == (TypeBit(EInventoryItemType::CONE) | TypeBit(EInventoryItemType::CUBE)));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CONE) == 7);
+	TestTrueExpr(InvComp->GetInventoryAmountByType(EInventoryItemType::CUBE) == 3);
+
+	AddInfo("Flush without pending changes doesn't broadcast");
+	InvComp->FlushInventoryChanges();
+	TestTrueExpr(Listener->Broadcasts.Num() == 1);
+
+	return true;
+}
+
+bool FConcurrentAddsKeepLimits::RunTest(const FString& Parameters)
+{
+	UTPInventoryComponentTestable* InvComp = NewObject<UTPInventoryComponentTestable>();
+	if (!TestNotNull("Inventory component exists", InvComp)) return false;
+
+	constexpr int32 Limit = 100000;
+	InvComp->SetLimits({ {EInventoryItemType::CONE, Limit},
+						{EInventoryItemType::CUBE, Limit},
+						{EInventoryItemType::CYLINDER, Limit},
+						{EInventoryItemType::SPHERE, Limit} });
+	InvComp->SetConcurrentAdds(true);
+
+	// Demand is several times the limits so threads keep racing for the last free space
+	const int32 NumTasks = FPlatformMisc::NumberOfCoresIncludingHyperthreads() * 4;
+	constexpr int32 AddsPerTask = 20000;
+
+	std::atomic<int64> Granted[InventoryItemTypeCount]{};
+	std::atomic<int32> FailedBatches{ 0 };
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+		{
+			FRandomStream Random(TaskIndex);
+			for (int32 AddIndex = 0; AddIndex < AddsPerTask; ++AddIndex)
+			{
+				const FInventoryData Data{ static_cast<EInventoryItemType>(Random.RandRange(0, InventoryItemTypeCount - 1)), Random.RandRange(0, 10) };
+				if (InvComp->TryToAddItem(Data))
+				{
+					Granted[static_cast<int32>(Data.Type)] += Data.Score;
+				}
+
+				if (AddIndex % 16 == 0)
+				{
+					const FInventoryData Bundle[] = { { EInventoryItemType::SPHERE, 3 }, { EInventoryItemType::CONE, 5 }, { EInventoryItemType::SPHERE, 2 } };
+					if (InvComp->TryToAddItems(Bundle))
+					{
+						Granted[static_cast<int32>(EInventoryItemType::SPHERE)] += 5;
+						Granted[static_cast<int32>(EInventoryItemType::CONE)] += 5;
+					}
+					else
+					{
+						++FailedBatches;
+					}
+				}
+			}
+		});
+
+	AddInfo(FString::Printf(TEXT("%d tasks, %d failed batches"), NumTasks, FailedBatches.load()));
+	for (int32 TypeIndex = 0; TypeIndex < InventoryItemTypeCount; ++TypeIndex)
+	{
+		const int32 Amount = InvComp->GetInventoryAmountByType(static_cast<EInventoryItemType>(TypeIndex));
+		TestTrueExpr(Amount <= Limit);
+		TestTrueExpr(Amount == Granted[TypeIndex].load());
+	}
+	TestTrueExpr(InvComp->GetDirtyTypesMask() != 0);
+
+	return true;
+}
+
+bool FInventoryBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TestProject;
+
+	UTPInventoryComponentTestable* InvComp = NewObject<UTPInventoryComponentTestable>();
+	if (!TestNotNull("Inventory component exists", InvComp)) return false;
+
+	// Limits are never reached, every call takes the full success path
+	InvComp->SetLimits({ {EInventoryItemType::CONE, MAX_int32},
+						{EInventoryItemType::CUBE, MAX_int32},
+						{EInventoryItemType::CYLINDER, MAX_int32},
+						{EInventoryItemType::SPHERE, MAX_int32} });
+
+	FBenchmarkScope Benchmark(*this);
+
+	int32 TypeIndex = 0;
+	Benchmark.Run("TryToAddItem", [InvComp, &TypeIndex]()
+		{
+			DoNotOptimize(InvComp->TryToAddItem({ static_cast<EInventoryItemType>(TypeIndex), 0 }));
+			TypeIndex = (TypeIndex + 1) % 4;
+		});
+	const TArray<FInventoryData> Bundle{ { EInventoryItemType::SPHERE, 0 }, { EInventoryItemType::CUBE, 0 },
+		{ EInventoryItemType::CYLINDER, 0 }, { EInventoryItemType::CONE, 0 } };
+	Benchmark.Run("TryToAddItems 4", [InvComp, &Bundle]()
+		{
+			DoNotOptimize(InvComp->TryToAddItems(Bundle));
+		});
+	Benchmark.Run("GetInventoryAmountByType", [InvComp, &TypeIndex]()
+		{
+			DoNotOptimize(InvComp->GetInventoryAmountByType(static_cast<EInventoryItemType>(TypeIndex)));
+			TypeIndex = (TypeIndex + 1) % 4;
+		});
+
+	return true;
+}
+
 #endif
\ No newline at end of file
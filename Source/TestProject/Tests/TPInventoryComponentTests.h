@@ -2,3 +2,19 @@
 
 #pragma once
 
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "TPInventoryComponentTests.generated.h"
+
+/** Records every OnInventoryChanged broadcast so tests can check how many were fired and with which mask. */
+UCLASS()
+class UTPInventoryChangedListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void OnInventoryChanged(int32 ChangedTypesMask) { Broadcasts.Add(ChangedTypesMask); }
+
+	TArray<int32> Broadcasts;
+};
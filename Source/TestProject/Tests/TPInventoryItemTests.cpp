@@ -9,6 +9,7 @@
 #include "Tests/TestUtils.h"
 #include "TPTypes.h"
 #include "Items/TPInventoryItem.h"
+#include "Items/TPPickupSubsystem.h"
 #include "Engine/World.h"
 #include "Engine/Blueprint.h"
 #include "Components/SphereComponent.h"
@@ -31,6 +32,9 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryDataShouldBeSetupCorrectly, "TestProj
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryCanBePickedUp, "TestProject.Items.Inventory.InventoryCanBePickedUp",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMovedInventoryCanBePickedUp, "TestProject.Items.Inventory.MovedInventoryCanBePickedUp",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEveryInventoryItemMeshExists, "TestProject.Items.Inventory.EveryInventoryItemMeshExists",
 	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter | EAutomationTestFlags::HighPriority);
 
@@ -73,12 +77,16 @@ bool FBlueprintShouldBeSetupCorrectly::RunTest(const FString& Parameters)
 	const auto CollisionComp = InvItem->FindComponentByClass<USphereComponent>();
 	if (!TestNotNull(TEXT("Sphere Collision Component exists"), CollisionComp)) return false;
 
+	// The sphere only defines the pickup radius, UTPPickupSubsystem resolves overlaps without physics
 	TestTrueExpr(CollisionComp->GetScaledSphereRadius() >= 30.0f);
-	TestTrueExpr(CollisionComp->GetCollisionEnabled() == ECollisionEnabled::QueryOnly);
-	TestTrueExpr(CollisionComp->GetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic) == ECollisionResponse::ECR_Overlap);
-	TestTrueExpr(CollisionComp->GetGenerateOverlapEvents());
+	TestTrueExpr(CollisionComp->GetCollisionEnabled() == ECollisionEnabled::NoCollision);
+	TestTrueExpr(!CollisionComp->GetGenerateOverlapEvents());
 	TestTrueExpr(InvItem->GetRootComponent() == CollisionComp);
 
+	const UTPPickupSubsystem* PickupSubsystem = World->GetSubsystem<UTPPickupSubsystem>();
+	if (!TestNotNull(TEXT("Pickup subsystem exists"), PickupSubsystem)) return false;
+	TestTrueExpr(PickupSubsystem->GetNumItems() >= 1);
+
 	const auto TextRenderComp = InvItem->FindComponentByClass<UTextRenderComponent>();
 	if (!TestNotNull(TEXT("Text renderer exists"), TextRenderComp)) return false;
 
@@ -166,6 +174,11 @@ bool FInventoryCanBePickedUp::RunTest(const FString& Parameters)
 
 	Pawn->SetActorLocation(InvItem->GetActorLocation());
 
+	// Pickups are resolved once per frame, don't wait for the next tick
+	UTPPickupSubsystem* PickupSubsystem = World->GetSubsystem<UTPPickupSubsystem>();
+	if (!TestNotNull(TEXT("Pickup subsystem exists"), PickupSubsystem)) return false;
+	PickupSubsystem->UpdatePickups();
+
 	TestTrueExpr(InvComp->GetInventoryAmountByType(InvData.Type) == InvData.Score);
 	TestTrueExpr(!IsValid(InvItem));
 
@@ -176,6 +189,54 @@ bool FInventoryCanBePickedUp::RunTest(const FString& Parameters)
 	return true;
 }
 
+bool FMovedInventoryCanBePickedUp::RunTest(const FString& Parameters)
+{
+	LevelScope("/Game/Tests/EmptyTestLevel");
+
+	UWorld* World = GetTestGameWorld();
+	if (!TestNotNull(TEXT("World exists"), World)) return false;
+
+	TArray<AActor*> Pawns;
+	UGameplayStatics::GetAllActorsOfClass(World, ATestProjectCharacter::StaticClass(), Pawns);
+	if (!TestTrueExpr(Pawns.Num() == 1)) return false;
+
+	const auto Pawn = Cast<ATestProjectCharacter>(Pawns[0]);
+	if (!TestNotNull(TEXT("Character exists"), Pawn)) return false;
+
+	const auto InvComp = Pawn->FindComponentByClass<UTPInventoryComponent>();
+	if (!TestNotNull(TEXT("Inventory component exists"), InvComp)) return false;
+
+	const UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *InventoryItemBPTestName);
+	if (!TestNotNull(TEXT("Inventory item exists"), Blueprint)) return false;
+
+	// Spawned out of reach, the grid has to follow the item once it's moved onto the pawn
+	const FTransform FarTransform(Pawn->GetActorLocation() + FVector(1000.0f, 0.0f, 0.0f));
+	ATPInventoryItem* InvItem = World->SpawnActor<ATPInventoryItem>(Blueprint->GeneratedClass, FarTransform);
+	if (!TestNotNull(TEXT("Inventory item exists"), InvItem)) return false;
+
+	const FInventoryData InvData{ EInventoryItemType::CYLINDER, 13 };
+	CallFuncByNameWithParams(InvItem, "SetInventoryData",
+		{
+			InvData.ToString(),
+			FLinearColor::Green.ToString()
+		});
+
+	UTPPickupSubsystem* PickupSubsystem = World->GetSubsystem<UTPPickupSubsystem>();
+	if (!TestNotNull(TEXT("Pickup subsystem exists"), PickupSubsystem)) return false;
+
+	PickupSubsystem->UpdatePickups();
+	TestTrueExpr(IsValid(InvItem));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(InvData.Type) == 0);
+
+	InvItem->SetActorLocation(Pawn->GetActorLocation());
+	PickupSubsystem->UpdatePickups();
+
+	TestTrueExpr(!IsValid(InvItem));
+	TestTrueExpr(InvComp->GetInventoryAmountByType(InvData.Type) == InvData.Score);
+
+	return true;
+}
+
 bool FEveryInventoryItemMeshExists::RunTest(const FString& Parameters)
 {
 	LevelScope("/Game/Tests/EmptyTestLevel");
@@ -7,6 +7,9 @@
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "Misc/OutputDeviceNull.h"
+#include "Async/Future.h"
+
+class AWorldSettings;
 
 namespace TestProject
 {
@@ -34,6 +37,52 @@ namespace TestProject
 		}
 	};
 
+	/**
+	 * Ticks the engine with a fixed delta time as fast as the CPU allows while alive, so replays run deterministically
+	 * and don't wait for the wall clock. TimeDilation additionally scales the world time advanced per tick.
+	 * Declare it after LevelScope, the previous fixed step and time dilation are restored by a latent command once the
+	 * test commands are done, before the level is closed.
+	 */
+	class FixedTimeStepScope
+	{
+	public:
+		FixedTimeStepScope(UWorld* World, double FixedDeltaTime, float TimeDilation = 1.0f);
+		~FixedTimeStepScope();
+
+	private:
+		bool bEnabled{ false };
+		bool bPrevUseFixedTimeStep{ false };
+		double PrevFixedDeltaTime{ 0.0 };
+		TWeakObjectPtr<AWorldSettings> WorldSettings;
+		float PrevTimeDilation{ 1.0f };
+	};
+
+	/**
+	 * Waits for work started before the level was opened, e.g. TRecordingSerializer<T>::ReadAsync,
+	 * and hands the result to Callback on the game thread. Later commands can keep reading the same shared future.
+	 */
+	template<typename ResultType>
+	class TWaitForFutureLatentCommand : public IAutomationLatentCommand
+	{
+	public:
+		TWaitForFutureLatentCommand(TSharedFuture<ResultType> InFuture, TFunction<void(const ResultType&)> InCallback)
+			: Future(MoveTemp(InFuture))
+			, Callback(MoveTemp(InCallback))
+		{}
+
+		virtual bool Update() override
+		{
+			if (!Future.IsReady()) return false;
+
+			Callback(Future.Get());
+			return true;
+		}
+
+	private:
+		TSharedFuture<ResultType> Future;
+		TFunction<void(const ResultType&)> Callback;
+	};
+
 	class FCustomUntilCommand : public IAutomationLatentCommand
 	{
 	public:
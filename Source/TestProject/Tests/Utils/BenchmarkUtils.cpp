@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/BenchmarkUtils.h"
+#include "Tests/Utils/JsonUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBenchmark, All, All);
+
+namespace TestProject
+{
+	namespace
+	{
+		// Calibration stops doubling here so a body that is optimized away can't spin forever
+		constexpr int64 MaxIterations = int64(1) << 30;
+
+		TAutoConsoleVariable<bool> CVarRecordBaselines(TEXT("TestProject.Benchmark.RecordBaselines"), false,
+			TEXT("Store benchmark results as the new baselines of this machine class instead of comparing against them."));
+
+		TAutoConsoleVariable<FString> CVarMachineClass(TEXT("TestProject.Benchmark.MachineClass"), TEXT(""),
+			TEXT("Machine class benchmark baselines are stored under, empty uses CPU, core count and build configuration."));
+
+		TAutoConsoleVariable<bool> CVarRequireBaselines(TEXT("TestProject.Benchmark.RequireBaselines"), false,
+			TEXT("Fail benchmarks without a baseline for this machine class instead of warning, for CI machines with recorded baselines."));
+
+		TAutoConsoleVariable<float> CVarTolerance(TEXT("TestProject.Benchmark.Tolerance"), 0.1f,
+			TEXT("Relative slowdown of the median over its baseline that is accepted before noise."));
+
+		TAutoConsoleVariable<float> CVarMadScale(TEXT("TestProject.Benchmark.MadScale"), 3.0f,
+			TEXT("Median absolute deviations accepted on top of the tolerance as measurement noise."));
+
+		double Percentile(const TArray<double>& SortedValues, double Fraction)
+		{
+			const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+			return SortedValues[Index];
+		}
+	}
+
+	FBenchmarkScope::FBenchmarkScope(FAutomationTestBase& InTest, const FBenchmarkSettings& InSettings)
+		: Test(InTest)
+		, Settings(InSettings)
+	{
+		Report.Test = Test.GetTestFullName();
+	}
+
+	FBenchmarkScope::~FBenchmarkScope()
+	{
+		if (Report.Results.IsEmpty()) return;
+
+		if (!WriteArtifacts())
+		{
+			Test.AddWarning(FString::Printf(TEXT("Benchmark results can't be written to %s"), *GetArtifactDir()));
+		}
+		CheckBaselines();
+	}
+
+	FString FBenchmarkScope::GetArtifactDir()
+	{
+		return FPaths::Combine(FPaths::AutomationDir(), TEXT("Benchmarks"));
+	}
+
+	FString FBenchmarkScope::GetBaselinesPath()
+	{
+		return FPaths::GameSourceDir().Append("TestProject/Tests/Data/PerfBaselines.json");
+	}
+
+	FString FBenchmarkScope::GetMachineClass()
+	{
+		const FString MachineClass = CVarMachineClass.GetValueOnGameThread();
+		if (!MachineClass.IsEmpty()) return MachineClass;
+
+		return FString::Printf(TEXT("%s x%d %s"), *FPlatformMisc::GetCPUBrand().TrimStartAndEnd(),
+			FPlatformMisc::NumberOfCoresIncludingHyperthreads(), LexToString(FApp::GetBuildConfiguration()));
+	}
+
+	bool FBenchmarkScope::IsRegression(const FBenchmarkResult& Result, const FPerfBaseline& Baseline, double Tolerance, double MadScale)
+	{
+		const double Noise = FMath::Max(Baseline.MedianAbsoluteDeviation, Result.MedianAbsoluteDeviation);
+		return Result.Median > Baseline.Median * (1.0 + Tolerance) + MadScale * Noise;
+	}
+
+	FBenchmarkResult FBenchmarkScope::Measure(const FString& Name, TFunctionRef<void(int64)> RunBatch)
+	{
+		const auto TimeBatch = [&RunBatch](int64 Iterations)
+			{
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+				RunBatch(Iterations);
+				return FPlatformTime::GetSecondsPerCycle64() * (FPlatformTime::Cycles64() - StartCycles);
+			};
+
+		int64 Iterations = 1;
+		while (TimeBatch(Iterations) < Settings.MinSampleSeconds && Iterations < MaxIterations)
+		{
+			Iterations *= 2;
+		}
+
+		const double WarmupEnd = FPlatformTime::Seconds() + Settings.WarmupSeconds;
+		while (FPlatformTime::Seconds() < WarmupEnd)
+		{
+			TimeBatch(Iterations);
+		}
+
+		TArray<double> Samples;
+		Samples.Reserve(Settings.NumSamples);
+		for (int32 SampleIndex = 0; SampleIndex < FMath::Max(Settings.NumSamples, 1); ++SampleIndex)
+		{
+			Samples.Add(TimeBatch(Iterations) * 1.0e9 / Iterations);
+		}
+		Samples.Sort();
+
+		FBenchmarkResult Result;
+		Result.Name = Name;
+		Result.Iterations = Iterations;
+		Result.Samples = Samples.Num();
+		Result.Min = Samples[0];
+		Result.Median = Percentile(Samples, 0.5);
+		Result.P99 = Percentile(Samples, 0.99);
+		TArray<double> Deviations;
+		for (const double Sample : Samples)
+		{
+			Result.Mean += Sample / Samples.Num();
+			Deviations.Add(FMath::Abs(Sample - Result.Median));
+		}
+		Deviations.Sort();
+		Result.MedianAbsoluteDeviation = Percentile(Deviations, 0.5);
+
+		Test.AddInfo(FString::Printf(TEXT("%s: min %.2f ns, median %.2f ns (MAD %.2f), p99 %.2f ns (%d x %lld iterations)"),
+			*Name, Result.Min, Result.Median, Result.MedianAbsoluteDeviation, Result.P99, Result.Samples, Result.Iterations));
+		Report.Results.Add(Result);
+		return Result;
+	}
+
+	bool FBenchmarkScope::WriteArtifacts() const
+	{
+		const FString BaseName = FPaths::Combine(GetArtifactDir(), FPaths::MakeValidFileName(Report.Test, TEXT('_')));
+
+		FString Csv = TEXT("Test,Name,Iterations,Samples,MinNs,MedianNs,P99Ns,MeanNs,MadNs\n");
+		for (const FBenchmarkResult& Result : Report.Results)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%lld,%d,%f,%f,%f,%f,%f\n"), *Report.Test, *Result.Name,
+				Result.Iterations, Result.Samples, Result.Min, Result.Median, Result.P99, Result.Mean, Result.MedianAbsoluteDeviation);
+		}
+
+		if (!FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv")))) return false;
+		if (!TRecordingSerializer<FBenchmarkReport>::Write(BaseName + TEXT(".json"), Report)) return false;
+
+		UE_LOG(LogBenchmark, Display, TEXT("Benchmark results written to %s.csv/.json"), *BaseName);
+		return true;
+	}
+
+	void FBenchmarkScope::CheckBaselines()
+	{
+		const FString BaselinesPath = GetBaselinesPath();
+		const FString MachineClass = GetMachineClass();
+
+		FPerfBaselines Baselines;
+		if (FPaths::FileExists(BaselinesPath) && !TRecordingSerializer<FPerfBaselines>::Read(BaselinesPath, Baselines))
+		{
+			Test.AddError(FString::Printf(TEXT("Perf baselines can't be read from %s"), *BaselinesPath));
+			return;
+		}
+
+		const auto FindBaseline = [&](const FBenchmarkResult& Result)
+			{
+				return Baselines.Baselines.FindByPredicate([&](const FPerfBaseline& Baseline)
+					{
+						return Baseline.Test == Report.Test && Baseline.MachineClass == MachineClass && Baseline.Name == Result.Name;
+					});
+			};
+
+		if (CVarRecordBaselines.GetValueOnGameThread() || FParse::Param(FCommandLine::Get(), TEXT("RecordPerfBaselines")))
+		{
+			for (const FBenchmarkResult& Result : Report.Results)
+			{
+				FPerfBaseline* Baseline = FindBaseline(Result);
+				if (!Baseline)
+				{
+					Baseline = &Baselines.Baselines.AddDefaulted_GetRef();
+					Baseline->Test = Report.Test;
+					Baseline->MachineClass = MachineClass;
+					Baseline->Name = Result.Name;
+				}
+				Baseline->Median = Result.Median;
+				Baseline->MedianAbsoluteDeviation = Result.MedianAbsoluteDeviation;
+			}
+
+			if (!TRecordingSerializer<FPerfBaselines>::Write(BaselinesPath, Baselines))
+			{
+				Test.AddError(FString::Printf(TEXT("Perf baselines can't be written to %s"), *BaselinesPath));
+				return;
+			}
+			Test.AddInfo(FString::Printf(TEXT("Recorded %d baselines for %s"), Report.Results.Num(), *MachineClass));
+			return;
+		}
+
+		const double Tolerance = CVarTolerance.GetValueOnGameThread();
+		const double MadScale = CVarMadScale.GetValueOnGameThread();
+		TArray<FString> MissingBaselines;
+		for (const FBenchmarkResult& Result : Report.Results)
+		{
+			const FPerfBaseline* Baseline = FindBaseline(Result);
+			if (!Baseline)
+			{
+				MissingBaselines.Add(Result.Name);
+				continue;
+			}
+
+			if (IsRegression(Result, *Baseline, Tolerance, MadScale))
+			{
+				Test.AddError(FString::Printf(TEXT("%s regressed: median %.2f ns, baseline %.2f ns (MAD %.2f)"),
+					*Result.Name, Result.Median, Baseline->Median, Baseline->MedianAbsoluteDeviation));
+			}
+		}
+
+		// Nothing is gated without a baseline, that has to show up in CI rather than pass silently
+		if (MissingBaselines.Num() > 0)
+		{
+			const FString Message = FString::Printf(TEXT("No perf baseline for %s on %s, record them with -RecordPerfBaselines: %s"),
+				*Report.Test, *MachineClass, *FString::Join(MissingBaselines, TEXT(", ")));
+			if (CVarRequireBaselines.GetValueOnGameThread())
+			{
+				Test.AddError(Message);
+			}
+			else
+			{
+				Test.AddWarning(Message);
+			}
+		}
+	}
+}
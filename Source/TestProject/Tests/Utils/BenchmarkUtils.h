@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "BenchmarkUtils.generated.h"
+
+/** Timing of one benchmarked body, all times are nanoseconds per iteration. */
+USTRUCT()
+struct FBenchmarkResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+
+	// Iterations timed together in one sample
+	UPROPERTY()
+	int64 Iterations{ 0 };
+
+	UPROPERTY()
+	int32 Samples{ 0 };
+
+	UPROPERTY()
+	double Min{ 0.0 };
+
+	UPROPERTY()
+	double Median{ 0.0 };
+
+	UPROPERTY()
+	double P99{ 0.0 };
+
+	UPROPERTY()
+	double Mean{ 0.0 };
+
+	// Median absolute deviation of the samples from Median, the noise estimate regressions are judged by
+	UPROPERTY()
+	double MedianAbsoluteDeviation{ 0.0 };
+};
+
+/** Everything one benchmark test measured, written to Saved/Automation/Benchmarks as JSON and CSV. */
+USTRUCT()
+struct FBenchmarkReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Test;
+
+	UPROPERTY()
+	TArray<FBenchmarkResult> Results;
+};
+
+/** Accepted timing of one benchmark body on one class of machine. */
+USTRUCT()
+struct FPerfBaseline
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Test;
+
+	UPROPERTY()
+	FString MachineClass;
+
+	UPROPERTY()
+	FString Name;
+
+	UPROPERTY()
+	double Median{ 0.0 };
+
+	UPROPERTY()
+	double MedianAbsoluteDeviation{ 0.0 };
+};
+
+/** Committed as Tests/Data/PerfBaselines.json. */
+USTRUCT()
+struct FPerfBaselines
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FPerfBaseline> Baselines;
+};
+
+namespace TestProject
+{
+	struct FBenchmarkSettings
+	{
+		// Calibrated body is run this long before sampling
+		double WarmupSeconds{ 0.05 };
+
+		// Iterations per sample are doubled until a sample takes at least this long
+		double MinSampleSeconds{ 0.002 };
+
+		int32 NumSamples{ 51 };
+	};
+
+	/** Keeps the compiler from removing the computation of Value, it is treated as read by unknown code. */
+	template<typename ValueType>
+	FORCEINLINE void DoNotOptimize(const ValueType& Value)
+	{
+#if PLATFORM_COMPILER_CLANG || defined(__GNUC__)
+		asm volatile("" : : "r,m"(Value) : "memory");
+#else
+		const volatile char* Address = reinterpret_cast<const volatile char*>(&Value);
+		(void)*Address;
+		_ReadWriteBarrier();
+#endif
+	}
+
+	/**
+	 * Measures bodies for the test it is declared in and writes the report when it goes out of scope.
+	 * Each body is warmed up, run in batches sized so timer resolution doesn't matter, and reported as min/median/p99.
+	 * Results are compared against Tests/Data/PerfBaselines.json for the current machine class,
+	 * run with TestProject.Benchmark.RecordBaselines 1 or -RecordPerfBaselines to store them as the new baselines instead.
+	 * Results without a baseline are reported as a warning, or as an error with TestProject.Benchmark.RequireBaselines 1.
+	 */
+	class FBenchmarkScope
+	{
+	public:
+		explicit FBenchmarkScope(FAutomationTestBase& InTest, const FBenchmarkSettings& InSettings = {});
+		~FBenchmarkScope();
+
+		/** Body is called once per iteration, wrap what it computes in DoNotOptimize. */
+		template<typename BodyType>
+		FBenchmarkResult Run(const FString& Name, BodyType&& Body)
+		{
+			return Measure(Name, [&Body](int64 Iterations)
+				{
+					for (int64 Iteration = 0; Iteration < Iterations; ++Iteration)
+					{
+						Body();
+					}
+				});
+		}
+
+		const FBenchmarkReport& GetReport() const { return Report; }
+
+		static FString GetArtifactDir();
+		static FString GetBaselinesPath();
+
+		/** CPU, core count and build configuration, or TestProject.Benchmark.MachineClass if it is set. */
+		static FString GetMachineClass();
+
+		/**
+		 * Slower than the baseline beyond noise: the median is above
+		 * Baseline.Median * (1 + Tolerance) + MadScale * max(baseline MAD, current MAD).
+		 */
+		static bool IsRegression(const FBenchmarkResult& Result, const FPerfBaseline& Baseline, double Tolerance, double MadScale);
+
+	private:
+		FBenchmarkResult Measure(const FString& Name, TFunctionRef<void(int64)> RunBatch);
+		bool WriteArtifacts() const;
+
+		/** Fails the test on regressions and warns about missing baselines, or replaces the baselines in record mode. */
+		void CheckBaselines();
+
+		FAutomationTestBase& Test;
+		FBenchmarkSettings Settings;
+		FBenchmarkReport Report;
+	};
+}
+
+/** Simple automation test in the perf filter, its RunTest is expected to declare a FBenchmarkScope. */
+#define IMPLEMENT_BENCHMARK_TEST(TClass, PrettyName) \
+	IMPLEMENT_SIMPLE_AUTOMATION_TEST(TClass, PrettyName, \
+		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter | EAutomationTestFlags::LowPriority)
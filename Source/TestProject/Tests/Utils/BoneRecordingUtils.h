@@ -40,4 +40,39 @@ struct FRecordingAnimationData
 
 	UPROPERTY()
 	FTransform InitialTransform;
+};
+
+/**
+ * Layout of one compact pose sample captured by UBonesPositionRecorder:
+ * WorldTime, component-to-world transform, then component space positions and rotations as SoA.
+ * Bone names aren't stored per sample, they are resolved once when recording starts.
+ */
+struct FRecordingPoseLayout
+{
+	explicit FRecordingPoseLayout(int32 InNumBones = 0)
+		: NumBones(InNumBones),
+		RotationsOffset(Align(PositionsOffset + InNumBones * static_cast<int32>(sizeof(FVector3f)), 16)),
+		Size(Align(RotationsOffset + InNumBones * static_cast<int32>(sizeof(FQuat4f)), 16))
+	{
+	}
+
+	double& WorldTime(uint8* Record) const { return *reinterpret_cast<double*>(Record); }
+	double WorldTime(const uint8* Record) const { return *reinterpret_cast<const double*>(Record); }
+
+	// Rotation XYZW, Translation XYZ, Scale3D XYZ
+	double* ComponentToWorld(uint8* Record) const { return reinterpret_cast<double*>(Record + ComponentToWorldOffset); }
+	const double* ComponentToWorld(const uint8* Record) const { return reinterpret_cast<const double*>(Record + ComponentToWorldOffset); }
+
+	FVector3f* Positions(uint8* Record) const { return reinterpret_cast<FVector3f*>(Record + PositionsOffset); }
+	const FVector3f* Positions(const uint8* Record) const { return reinterpret_cast<const FVector3f*>(Record + PositionsOffset); }
+
+	FQuat4f* Rotations(uint8* Record) const { return reinterpret_cast<FQuat4f*>(Record + RotationsOffset); }
+	const FQuat4f* Rotations(const uint8* Record) const { return reinterpret_cast<const FQuat4f*>(Record + RotationsOffset); }
+
+	static constexpr int32 ComponentToWorldOffset = sizeof(double);
+	static constexpr int32 PositionsOffset = ComponentToWorldOffset + 10 * sizeof(double);
+
+	int32 NumBones;
+	int32 RotationsOffset;
+	int32 Size;
 };
\ No newline at end of file
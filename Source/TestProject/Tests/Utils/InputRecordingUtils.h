@@ -17,6 +17,7 @@ struct FAxisData
 	FVector2D Value;
 };
 
+/** Input actions whose value changed at WorldTime, actions that aren't listed keep their previous value. */
 USTRUCT()
 struct FBindingsData
 {
@@ -31,6 +32,10 @@ struct FBindingsData
 	float WorldTime{ 0.0f };
 };
 
+/**
+ * Input recording stored as transitions: the first frame lists every recorded action once,
+ * later frames only the actions that changed. The last frame marks the end of the recording and may be empty.
+ */
 USTRUCT()
 struct FInputData
 {
@@ -41,4 +46,39 @@ struct FInputData
 
 	UPROPERTY()
 	FTransform InitialTransform;
+};
+
+struct FRecordingInputChange
+{
+	int32 Slot;
+	FVector2D Value;
+};
+
+/**
+ * Layout of one input sample captured by UTPInputRecordingComponent:
+ * WorldTime, number of changed slots, then the changed slots only.
+ * Slots are resolved once when recording starts, unchanged values are carried over when the sample is expanded.
+ */
+struct FRecordingInputLayout
+{
+	explicit FRecordingInputLayout(int32 InNumSlots = 0)
+		: NumSlots(InNumSlots),
+		Size(ChangesOffset + InNumSlots * static_cast<int32>(sizeof(FRecordingInputChange)))
+	{
+	}
+
+	double& WorldTime(uint8* Record) const { return *reinterpret_cast<double*>(Record); }
+	double WorldTime(const uint8* Record) const { return *reinterpret_cast<const double*>(Record); }
+
+	int32& NumChanges(uint8* Record) const { return *reinterpret_cast<int32*>(Record + NumChangesOffset); }
+	int32 NumChanges(const uint8* Record) const { return *reinterpret_cast<const int32*>(Record + NumChangesOffset); }
+
+	FRecordingInputChange* Changes(uint8* Record) const { return reinterpret_cast<FRecordingInputChange*>(Record + ChangesOffset); }
+	const FRecordingInputChange* Changes(const uint8* Record) const { return reinterpret_cast<const FRecordingInputChange*>(Record + ChangesOffset); }
+
+	static constexpr int32 NumChangesOffset = sizeof(double);
+	static constexpr int32 ChangesOffset = 2 * sizeof(double);
+
+	int32 NumSlots;
+	int32 Size;
 };
\ No newline at end of file
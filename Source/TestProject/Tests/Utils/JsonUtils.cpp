@@ -2,68 +2,333 @@
 
 
 #include "Tests/Utils/JsonUtils.h"
-#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
 #include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
 #include "JsonObjectConverter.h"
-#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/TextProperty.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJsonUtils, All, All);
 
 namespace TestProject
 {
-	bool JsonUtils::WriteInputData(const FString& FileName, const FInputData& InputData)
+	namespace
 	{
-		TSharedPtr<FJsonObject> MainJsonObject = FJsonObjectConverter::UStructToJsonObject(InputData);
-		if (!MainJsonObject.IsValid()) return false;
+		using FRecordingJsonWriter = TJsonWriter<UTF8CHAR, TPrettyJsonPrintPolicy<UTF8CHAR>>;
+		using FRecordingJsonReader = TJsonReader<UTF8CHAR>;
 
-		FString OutputString;
-		TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&OutputString);
+		constexpr EPropertyFlags SkippedPropertyFlags = CPF_Deprecated | CPF_Transient;
 
-		if (!FJsonSerializer::Serialize(MainJsonObject.ToSharedRef(), JsonWriter)) return false;
-		if (!JsonWriter->Close()) return false;
+		/** JSON names of the serialized properties, resolved once per struct instead of once per value. */
+		class FJsonFieldCache
+		{
+		public:
+			const TArray<TPair<FString, const FProperty*>>& GetFields(const UStruct* Struct)
+			{
+				if (const TArray<TPair<FString, const FProperty*>>* Fields = FieldsByStruct.Find(Struct))
+				{
+					return *Fields;
+				}
 
-		if (!FFileHelper::SaveStringToFile(OutputString, *FileName)) return false;
+				TArray<TPair<FString, const FProperty*>>& Fields = FieldsByStruct.Add(Struct);
+				for (TFieldIterator<FProperty> It(Struct); It; ++It)
+				{
+					if (It->HasAnyPropertyFlags(SkippedPropertyFlags)) continue;
+					Fields.Emplace(FJsonObjectConverter::StandardizeCase(It->GetName()), *It);
+				}
+				return Fields;
+			}
 
-		return true;
+			const FProperty* FindField(const UStruct* Struct, const FString& Name)
+			{
+				// FString comparison is case insensitive, same as FJsonObject field lookup
+				for (const TPair<FString, const FProperty*>& Field : GetFields(Struct))
+				{
+					if (Field.Key == Name) return Field.Value;
+				}
+				return nullptr;
+			}
+
+		private:
+			TMap<const UStruct*, TArray<TPair<FString, const FProperty*>>> FieldsByStruct;
+		};
+
+		template<typename ValueType>
+		void WriteJsonValue(FRecordingJsonWriter& Writer, const FString* Identifier, const ValueType& Value)
+		{
+			if (Identifier)
+			{
+				Writer.WriteValue(*Identifier, Value);
+			}
+			else
+			{
+				Writer.WriteValue(Value);
+			}
+		}
+
+		bool WriteProperty(FRecordingJsonWriter& Writer, FJsonFieldCache& Cache, const FString* Identifier, const FProperty* Property, const void* Value);
+
+		bool WriteStructValue(FRecordingJsonWriter& Writer, FJsonFieldCache& Cache, const FString* Identifier, const UStruct* Struct, const void* Data)
+		{
+			if (Identifier)
+			{
+				Writer.WriteObjectStart(*Identifier);
+			}
+			else
+			{
+				Writer.WriteObjectStart();
+			}
+			for (const TPair<FString, const FProperty*>& Field : Cache.GetFields(Struct))
+			{
+				if (!WriteProperty(Writer, Cache, &Field.Key, Field.Value, Field.Value->ContainerPtrToValuePtr<void>(Data))) return false;
+			}
+			Writer.WriteObjectEnd();
+			return true;
+		}
+
+		bool WriteProperty(FRecordingJsonWriter& Writer, FJsonFieldCache& Cache, const FString* Identifier, const FProperty* Property, const void* Value)
+		{
+			if (Property->ArrayDim != 1)
+			{
+				UE_LOG(LogJsonUtils, Error, TEXT("Static array %s isn't supported"), *Property->GetName());
+				return false;
+			}
+
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				return WriteStructValue(Writer, Cache, Identifier, StructProperty->Struct, Value);
+			}
+			if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+				if (Identifier)
+				{
+					Writer.WriteArrayStart(*Identifier);
+				}
+				else
+				{
+					Writer.WriteArrayStart();
+				}
+				for (int32 Index = 0; Index < ArrayHelper.Num(); ++Index)
+				{
+					if (!WriteProperty(Writer, Cache, nullptr, ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index))) return false;
+				}
+				Writer.WriteArrayEnd();
+				return true;
+			}
+			if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				const int64 EnumValue = EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value);
+				WriteJsonValue(Writer, Identifier, EnumProperty->GetEnum()->GetNameStringByValue(EnumValue));
+				return true;
+			}
+			if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+			{
+				if (const UEnum* Enum = NumericProperty->GetIntPropertyEnum())
+				{
+					WriteJsonValue(Writer, Identifier, Enum->GetNameStringByValue(NumericProperty->GetSignedIntPropertyValue(Value)));
+				}
+				else if (NumericProperty->IsFloatingPoint())
+				{
+					// Floats are widened like FJsonValueNumber does, so the printed digits don't change
+					WriteJsonValue(Writer, Identifier, NumericProperty->GetFloatingPointPropertyValue(Value));
+				}
+				else
+				{
+					WriteJsonValue(Writer, Identifier, NumericProperty->GetSignedIntPropertyValue(Value));
+				}
+				return true;
+			}
+			if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+			{
+				WriteJsonValue(Writer, Identifier, BoolProperty->GetPropertyValue(Value));
+				return true;
+			}
+			if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+			{
+				WriteJsonValue(Writer, Identifier, NameProperty->GetPropertyValue(Value).ToString());
+				return true;
+			}
+			if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+			{
+				WriteJsonValue(Writer, Identifier, StrProperty->GetPropertyValue(Value));
+				return true;
+			}
+			if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+			{
+				WriteJsonValue(Writer, Identifier, TextProperty->GetPropertyValue(Value).ToString());
+				return true;
+			}
+
+			UE_LOG(LogJsonUtils, Error, TEXT("%s of type %s can't be written"), *Property->GetName(), *Property->GetCPPType());
+			return false;
+		}
+
+		void SkipValue(FRecordingJsonReader& Reader, EJsonNotation Notation)
+		{
+			if (Notation == EJsonNotation::ObjectStart)
+			{
+				Reader.SkipObject();
+			}
+			else if (Notation == EJsonNotation::ArrayStart)
+			{
+				Reader.SkipArray();
+			}
+		}
+
+		bool ReadProperty(FRecordingJsonReader& Reader, FJsonFieldCache& Cache, EJsonNotation Notation, const FProperty* Property, void* Value);
+
+		bool ReadStructValue(FRecordingJsonReader& Reader, FJsonFieldCache& Cache, const UStruct* Struct, void* Data)
+		{
+			EJsonNotation Notation;
+			while (Reader.ReadNext(Notation))
+			{
+				if (Notation == EJsonNotation::ObjectEnd) return true;
+
+				const FProperty* Property = Cache.FindField(Struct, Reader.GetIdentifier());
+				if (!Property)
+				{
+					SkipValue(Reader, Notation);
+					continue;
+				}
+				if (!ReadProperty(Reader, Cache, Notation, Property, Property->ContainerPtrToValuePtr<void>(Data))) return false;
+			}
+			return false;
+		}
+
+		bool ReadProperty(FRecordingJsonReader& Reader, FJsonFieldCache& Cache, EJsonNotation Notation, const FProperty* Property, void* Value)
+		{
+			if (Notation == EJsonNotation::Null) return true;
+
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				return Notation == EJsonNotation::ObjectStart && ReadStructValue(Reader, Cache, StructProperty->Struct, Value);
+			}
+			if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				if (Notation != EJsonNotation::ArrayStart) return false;
+
+				FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+				ArrayHelper.EmptyValues();
+				EJsonNotation ElementNotation;
+				while (Reader.ReadNext(ElementNotation))
+				{
+					if (ElementNotation == EJsonNotation::ArrayEnd) return true;
+					const int32 Index = ArrayHelper.AddValue();
+					if (!ReadProperty(Reader, Cache, ElementNotation, ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index))) return false;
+				}
+				return false;
+			}
+			if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				const int64 EnumValue = Notation == EJsonNotation::String
+					? EnumProperty->GetEnum()->GetValueByNameString(Reader.GetValueAsString())
+					: static_cast<int64>(Reader.GetValueAsNumber());
+				if (EnumValue == INDEX_NONE) return false;
+				EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(Value, EnumValue);
+				return true;
+			}
+			if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+			{
+				const UEnum* Enum = NumericProperty->GetIntPropertyEnum();
+				if (Enum && Notation == EJsonNotation::String)
+				{
+					const int64 EnumValue = Enum->GetValueByNameString(Reader.GetValueAsString());
+					if (EnumValue == INDEX_NONE) return false;
+					NumericProperty->SetIntPropertyValue(Value, EnumValue);
+					return true;
+				}
+				if (Notation != EJsonNotation::Number) return false;
+
+				if (NumericProperty->IsFloatingPoint())
+				{
+					NumericProperty->SetFloatingPointPropertyValue(Value, Reader.GetValueAsNumber());
+				}
+				else
+				{
+					NumericProperty->SetIntPropertyValue(Value, static_cast<int64>(Reader.GetValueAsNumber()));
+				}
+				return true;
+			}
+			if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+			{
+				if (Notation != EJsonNotation::Boolean) return false;
+				BoolProperty->SetPropertyValue(Value, Reader.GetValueAsBoolean());
+				return true;
+			}
+			if (Notation != EJsonNotation::String) return false;
+
+			if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+			{
+				NameProperty->SetPropertyValue(Value, FName(Reader.GetValueAsString()));
+				return true;
+			}
+			if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+			{
+				StrProperty->SetPropertyValue(Value, Reader.GetValueAsString());
+				return true;
+			}
+			if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+			{
+				TextProperty->SetPropertyValue(Value, FText::FromString(Reader.GetValueAsString()));
+				return true;
+			}
+
+			UE_LOG(LogJsonUtils, Error, TEXT("%s of type %s can't be read"), *Property->GetName(), *Property->GetCPPType());
+			return false;
+		}
 	}
 
-	bool JsonUtils::ReadInputData(const FString& FileName, FInputData& InputData)
+	bool JsonUtils::WriteInputData(const FString& FileName, const FInputData& InputData)
 	{
-		TSharedPtr<FJsonObject> MainJsonObject = MakeShareable(new FJsonObject());
+		return TRecordingSerializer<FInputData>::Write(FileName, InputData);
+	}
 
-		FString FileContentString;
-		if (!FFileHelper::LoadFileToString(FileContentString, *FileName)) return false;
+	bool JsonUtils::ReadInputData(const FString& FileName, FInputData& InputData)
+	{
+		return TRecordingSerializer<FInputData>::Read(FileName, InputData);
+	}
 
-		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(FileContentString);
-		if (!FJsonSerializer::Deserialize(JsonReader, MainJsonObject)) return false;
+	bool JsonUtils::WriteSkeletonData(const FString& FileName, const FRecordingAnimationData& AnimationData)
+	{
+		return TRecordingSerializer<FRecordingAnimationData>::Write(FileName, AnimationData);
+	}
 
-		return FJsonObjectConverter::JsonObjectToUStruct(MainJsonObject.ToSharedRef(), &InputData, 0, 0);
+	bool JsonUtils::ReadSkeletonData(const FString& FileName, FRecordingAnimationData& AnimationData)
+	{
+		return TRecordingSerializer<FRecordingAnimationData>::Read(FileName, AnimationData);
 	}
-	
-	bool JsonUtils::WriteSkeletonData(const FString& FileName, const FRecordingAnimationData& AnimationData)
+
+	bool JsonUtils::WriteStruct(const FString& FileName, const UScriptStruct* Struct, const void* Data)
 	{
-		TSharedPtr<FJsonObject> MainJsonObject = FJsonObjectConverter::UStructToJsonObject(AnimationData);
-		if (!MainJsonObject.IsValid()) return false;
-		
-		FString OutputString;
-		TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&OutputString);
+		TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*FileName));
+		if (!Archive) return false;
 
-		if (!FJsonSerializer::Serialize(MainJsonObject.ToSharedRef(), JsonWriter)) return false;
+		FJsonFieldCache Cache;
+		TSharedRef<FRecordingJsonWriter> JsonWriter = TJsonWriterFactory<UTF8CHAR, TPrettyJsonPrintPolicy<UTF8CHAR>>::Create(Archive.Get());
+		if (!WriteStructValue(*JsonWriter, Cache, nullptr, Struct, Data)) return false;
 		if (!JsonWriter->Close()) return false;
 
-		if (!FFileHelper::SaveStringToFile(OutputString, *FileName)) return false;
-
-		return true;
+		return Archive->Close() && !Archive->IsError();
 	}
 
-	bool JsonUtils::ReadSkeletonData(const FString& FileName, FRecordingAnimationData& AnimationData)
+	bool JsonUtils::ReadStruct(const FString& FileName, const UScriptStruct* Struct, void* Data)
 	{
-		TSharedPtr<FJsonObject> MainJsonObject = MakeShareable(new FJsonObject());
+		TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileReader(*FileName));
+		if (!Archive) return false;
 
-		FString FileContentString;
-		if (!FFileHelper::LoadFileToString(FileContentString, *FileName)) return false;
+		FJsonFieldCache Cache;
+		TSharedRef<FRecordingJsonReader> JsonReader = TJsonReaderFactory<UTF8CHAR>::Create(Archive.Get());
 
-		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(FileContentString);
-		if (!FJsonSerializer::Deserialize(JsonReader, MainJsonObject)) return false;
-
-		return FJsonObjectConverter::JsonObjectToUStruct(MainJsonObject.ToSharedRef(), &AnimationData, 0, 0);
+		EJsonNotation Notation;
+		if (!JsonReader->ReadNext(Notation) || Notation != EJsonNotation::ObjectStart) return false;
+		if (!ReadStructValue(*JsonReader, Cache, Struct, Data))
+		{
+			UE_LOG(LogJsonUtils, Error, TEXT("%s can't be read as %s: %s"), *FileName, *Struct->GetName(), *JsonReader->GetErrorMessage());
+			return false;
+		}
+		return true;
 	}
 }
@@ -5,6 +5,7 @@
 #include "TestProject/Tests/Utils/InputRecordingUtils.h"
 #include "TestProject/Tests/Utils/BoneRecordingUtils.h"
 #include "CoreMinimal.h"
+#include "Async/Async.h"
 
 namespace TestProject
 {
@@ -15,5 +16,48 @@ namespace TestProject
 		static bool ReadInputData(const FString& FileName, FInputData& InputData);
 		static bool WriteSkeletonData(const FString& FileName, const FRecordingAnimationData& AnimationData);
 		static bool ReadSkeletonData(const FString& FileName, FRecordingAnimationData& AnimationData);
+
+		/**
+		 * Streams a struct to a UTF-8 JSON file through its reflection data, nothing but the file buffer is kept in memory.
+		 * Field names and layout match FJsonObjectConverter, so both produce the same files.
+		 */
+		static bool WriteStruct(const FString& FileName, const UScriptStruct* Struct, const void* Data);
+
+		/** Pull-parses a JSON file straight into a struct, unknown fields are skipped and missing ones keep their value. */
+		static bool ReadStruct(const FString& FileName, const UScriptStruct* Struct, void* Data);
+	};
+
+	/** JSON file serialization of any USTRUCT recording, e.g. TRecordingSerializer<FInputData>::Read(FileName, InputData). */
+	template<typename RecordingType>
+	class TRecordingSerializer
+	{
+	public:
+		static bool Write(const FString& FileName, const RecordingType& Recording)
+		{
+			return JsonUtils::WriteStruct(FileName, RecordingType::StaticStruct(), &Recording);
+		}
+
+		static bool Read(const FString& FileName, RecordingType& Recording)
+		{
+			return JsonUtils::ReadStruct(FileName, RecordingType::StaticStruct(), &Recording);
+		}
+
+		/** Parses the file on the task graph, the result is null if it can't be read. */
+		static TFuture<TSharedPtr<RecordingType>> ReadAsync(const FString& FileName)
+		{
+			return Async(EAsyncExecution::TaskGraph, [FileName]() -> TSharedPtr<RecordingType>
+				{
+					TSharedPtr<RecordingType> Recording = MakeShared<RecordingType>();
+					return Read(FileName, *Recording) ? Recording : nullptr;
+				});
+		}
+
+		static TFuture<bool> WriteAsync(const FString& FileName, RecordingType Recording)
+		{
+			return Async(EAsyncExecution::TaskGraph, [FileName, Recording = MoveTemp(Recording)]()
+				{
+					return Write(FileName, Recording);
+				});
+		}
 	};
 }
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/OfflineAnimationUtils.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/AttributesRuntime.h"
+#include "BonePose.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOfflineAnimation, All, All);
+
+namespace TestProject
+{
+	bool OfflineAnimationUtils::MakeSetup(const USkeletalMeshComponent* Component, const FTransform& ActorTransform, FOfflineAnimationSetup& OutSetup)
+	{
+		if (!Component) return false;
+
+		if (Component->GetAnimationMode() != EAnimationMode::AnimationSingleNode)
+		{
+			UE_LOG(LogOfflineAnimation, Error, TEXT("%s doesn't play a single animation"), *Component->GetName());
+			return false;
+		}
+
+		OutSetup.Sequence = Cast<UAnimSequence>(Component->AnimationData.AnimToPlay);
+		OutSetup.SkeletalMesh = Component->GetSkeletalMeshAsset();
+		if (!OutSetup.Sequence || !OutSetup.SkeletalMesh) return false;
+
+		OutSetup.ComponentToWorld = Component->GetRelativeTransform() * ActorTransform;
+		OutSetup.PlayRate = Component->AnimationData.SavedPlayRate;
+		OutSetup.StartPosition = Component->AnimationData.SavedPosition;
+		OutSetup.bLooping = Component->AnimationData.bSavedLooping;
+		return true;
+	}
+
+	bool OfflineAnimationUtils::EvaluatePoses(const FOfflineAnimationSetup& Setup, TConstArrayView<FName> BoneNames, TConstArrayView<float> WorldTimes, TArray<FPoseSoA>& OutPoses)
+	{
+		if (!Setup.Sequence || !Setup.SkeletalMesh) return false;
+
+		const FReferenceSkeleton& ReferenceSkeleton = Setup.SkeletalMesh->GetRefSkeleton();
+		TArray<FBoneIndexType> RequiredBones;
+		for (int32 BoneIndex = 0; BoneIndex < ReferenceSkeleton.GetNum(); ++BoneIndex)
+		{
+			RequiredBones.Add(static_cast<FBoneIndexType>(BoneIndex));
+		}
+
+		TArray<int32> MeshBoneIndices;
+		for (const FName& BoneName : BoneNames)
+		{
+			const int32 BoneIndex = ReferenceSkeleton.FindBoneIndex(BoneName);
+			if (BoneIndex == INDEX_NONE)
+			{
+				UE_LOG(LogOfflineAnimation, Error, TEXT("Bone %s isn't in %s"), *BoneName.ToString(), *Setup.SkeletalMesh->GetName());
+				return false;
+			}
+			MeshBoneIndices.Add(BoneIndex);
+		}
+
+		const FBoneContainer BoneContainer(RequiredBones, UE::Anim::FCurveFilterSettings(UE::Anim::ECurveFilterMode::DisallowAll),
+			*const_cast<USkeletalMesh*>(Setup.SkeletalMesh));
+		const double PlayLength = Setup.Sequence->GetPlayLength();
+
+		OutPoses.SetNum(WorldTimes.Num());
+		ParallelFor(WorldTimes.Num(), [&](int32 SampleIndex)
+			{
+				double Time = Setup.StartPosition + (WorldTimes[SampleIndex] - Setup.StartWorldTime) * Setup.PlayRate;
+				if (Setup.bLooping && PlayLength > 0.0)
+				{
+					Time = FMath::Fmod(Time, PlayLength);
+					Time = Time < 0.0 ? Time + PlayLength : Time;
+				}
+				else
+				{
+					Time = FMath::Clamp(Time, 0.0, PlayLength);
+				}
+
+				FMemMark Mark(FMemStack::Get());
+				FCompactPose Pose;
+				Pose.SetBoneContainer(&BoneContainer);
+				FBlendedCurve Curve;
+				UE::Anim::FStackAttributeContainer Attributes;
+				FAnimationPoseData PoseData(Pose, Curve, Attributes);
+				Setup.Sequence->GetAnimationPose(PoseData, FAnimExtractContext(Time));
+
+				FCSPose<FCompactPose> ComponentSpacePose;
+				ComponentSpacePose.InitPose(Pose);
+
+				FPoseSoA& OutPose = OutPoses[SampleIndex];
+				OutPose.SetNumBones(MeshBoneIndices.Num());
+				for (int32 Index = 0; Index < MeshBoneIndices.Num(); ++Index)
+				{
+					const FCompactPoseBoneIndex CompactIndex = BoneContainer.MakeCompactPoseIndex(FMeshPoseBoneIndex(MeshBoneIndices[Index]));
+					const FTransform BoneTransform = ComponentSpacePose.GetComponentSpaceTransform(CompactIndex) * Setup.ComponentToWorld;
+					OutPose.SetBone(Index, BoneTransform.GetLocation(), BoneTransform.GetRotation());
+				}
+			});
+		return true;
+	}
+}
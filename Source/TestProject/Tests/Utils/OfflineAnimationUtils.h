@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "TestProject/Tests/Utils/PoseComparison.h"
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+namespace TestProject
+{
+	/** Single node animation playback, enough to reproduce a pose at any world time without a world. */
+	struct FOfflineAnimationSetup
+	{
+		const UAnimSequence* Sequence{ nullptr };
+		const USkeletalMesh* SkeletalMesh{ nullptr };
+		FTransform ComponentToWorld;
+		float PlayRate{ 1.0f };
+		float StartPosition{ 0.0f };
+		bool bLooping{ true };
+		// World time playback started at, BeginPlay of the recorded level
+		float StartWorldTime{ 0.0f };
+	};
+
+	class OfflineAnimationUtils
+	{
+	public:
+		/** Reads the single node animation of a (template) component placed under an actor at ActorTransform. */
+		static bool MakeSetup(const USkeletalMeshComponent* Component, const FTransform& ActorTransform, FOfflineAnimationSetup& OutSetup);
+
+		/**
+		 * Evaluates the world space pose of BoneNames at every world time straight from the animation sequence,
+		 * no world is ticked and nothing is rendered. Samples are independent and evaluated in parallel.
+		 */
+		static bool EvaluatePoses(const FOfflineAnimationSetup& Setup, TConstArrayView<FName> BoneNames, TConstArrayView<float> WorldTimes, TArray<FPoseSoA>& OutPoses);
+	};
+}
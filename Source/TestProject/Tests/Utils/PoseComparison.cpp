@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/PoseComparison.h"
+#include "Math/VectorRegister.h"
+
+namespace TestProject
+{
+	void FPoseSoA::SetNumBones(int32 InNumBones)
+	{
+		NumBones = InNumBones;
+		const int32 PaddedNumBones = Align(InNumBones, Lanes);
+		for (TArray<float>* Component : { &PositionX, &PositionY, &PositionZ, &RotationPitch, &RotationYaw, &RotationRoll })
+		{
+			Component->SetNumZeroed(PaddedNumBones);
+		}
+	}
+
+	void FPoseSoA::SetBone(int32 BoneIndex, const FVector& Position, const FRotator& Rotation)
+	{
+		PositionX[BoneIndex] = static_cast<float>(Position.X);
+		PositionY[BoneIndex] = static_cast<float>(Position.Y);
+		PositionZ[BoneIndex] = static_cast<float>(Position.Z);
+		RotationPitch[BoneIndex] = static_cast<float>(Rotation.Pitch);
+		RotationYaw[BoneIndex] = static_cast<float>(Rotation.Yaw);
+		RotationRoll[BoneIndex] = static_cast<float>(Rotation.Roll);
+	}
+
+	FRecordedPoseCursor::FRecordedPoseCursor(const FRecordingAnimationData& AnimationData)
+	{
+		const TArray<FRecordingSkeletonData>& Samples = AnimationData.SkeletonRecordings;
+		if (Samples.IsEmpty()) return;
+
+		for (const FRecordingBoneData& BoneData : Samples[0].BoneValues)
+		{
+			BoneNames.Add(BoneData.Name);
+		}
+
+		const int32 NumBones = BoneNames.Num();
+		Times.Reserve(Samples.Num());
+		Positions.Reserve(Samples.Num() * NumBones);
+		Rotations.Reserve(Samples.Num() * NumBones);
+		for (const FRecordingSkeletonData& SkeletonData : Samples)
+		{
+			// Samples with a different bone layout can't be interpolated against their neighbours
+			if (SkeletonData.BoneValues.Num() != NumBones) continue;
+
+			Times.Add(SkeletonData.WorldTime);
+			for (const FRecordingBoneData& BoneData : SkeletonData.BoneValues)
+			{
+				Positions.Add(BoneData.Position);
+				Rotations.Add(BoneData.Rotation.Quaternion());
+			}
+		}
+	}
+
+	void FRecordedPoseCursor::Sample(float Time, FPoseSoA& OutPose)
+	{
+		const int32 NumBones = GetNumBones();
+		if (OutPose.NumBones != NumBones)
+		{
+			OutPose.SetNumBones(NumBones);
+		}
+		if (IsEmpty()) return;
+
+		// Going back in time restarts the search, the common case only ever moves forward
+		if (Time < Times[Cursor])
+		{
+			Cursor = 0;
+		}
+		while (Cursor + 1 < Times.Num() && Times[Cursor + 1] <= Time)
+		{
+			++Cursor;
+		}
+
+		const int32 Next = FMath::Min(Cursor + 1, Times.Num() - 1);
+		const float Span = Times[Next] - Times[Cursor];
+		const float Alpha = Span > 0.0f ? FMath::Clamp((Time - Times[Cursor]) / Span, 0.0f, 1.0f) : 0.0f;
+
+		const FVector* FromPositions = Positions.GetData() + Cursor * NumBones;
+		const FVector* ToPositions = Positions.GetData() + Next * NumBones;
+		const FQuat* FromRotations = Rotations.GetData() + Cursor * NumBones;
+		const FQuat* ToRotations = Rotations.GetData() + Next * NumBones;
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			OutPose.SetBone(BoneIndex,
+				FMath::Lerp(FromPositions[BoneIndex], ToPositions[BoneIndex], Alpha),
+				FQuat::Slerp(FromRotations[BoneIndex], ToRotations[BoneIndex], Alpha));
+		}
+	}
+
+	FPoseComparisonReport::FPoseComparisonReport(const TArray<FName>& InBoneNames, float InPositionTolerance, float InRotationTolerance, int32 InMaxStoredMismatches)
+		: BoneNames(InBoneNames),
+		PositionTolerance(InPositionTolerance),
+		RotationTolerance(InRotationTolerance),
+		MaxStoredMismatches(InMaxStoredMismatches)
+	{
+		BoneStats.SetNum(BoneNames.Num());
+	}
+
+	void FPoseComparisonReport::ComparePoses(const FPoseSoA& Expected, const FPoseSoA& Actual, TArray<float>& OutPositionErrors, TArray<float>& OutRotationErrors)
+	{
+		check(Expected.NumBones == Actual.NumBones);
+
+		const int32 PaddedNumBones = Expected.PositionX.Num();
+		OutPositionErrors.SetNumUninitialized(PaddedNumBones);
+		OutRotationErrors.SetNumUninitialized(PaddedNumBones);
+
+		const auto AbsDelta = [](const TArray<float>& A, const TArray<float>& B, int32 Index)
+		{
+			return VectorAbs(VectorSubtract(VectorLoad(A.GetData() + Index), VectorLoad(B.GetData() + Index)));
+		};
+
+		// |NormalizeAxis(A - B)|: the remainder of the difference by 360, folded into [0, 180]
+		const VectorRegister4Float Float360 = VectorSetFloat1(360.0f);
+		const auto AbsAngleDelta = [&AbsDelta, &Float360](const TArray<float>& A, const TArray<float>& B, int32 Index)
+		{
+			const VectorRegister4Float Remainder = VectorMod360(AbsDelta(A, B, Index));
+			return VectorMin(Remainder, VectorSubtract(Float360, Remainder));
+		};
+
+		for (int32 Index = 0; Index < PaddedNumBones; Index += FPoseSoA::Lanes)
+		{
+			const VectorRegister4Float PositionError = VectorMax(AbsDelta(Expected.PositionX, Actual.PositionX, Index),
+				VectorMax(AbsDelta(Expected.PositionY, Actual.PositionY, Index), AbsDelta(Expected.PositionZ, Actual.PositionZ, Index)));
+			VectorStore(PositionError, OutPositionErrors.GetData() + Index);
+
+			const VectorRegister4Float RotationError = VectorMax(AbsAngleDelta(Expected.RotationPitch, Actual.RotationPitch, Index),
+				VectorMax(AbsAngleDelta(Expected.RotationYaw, Actual.RotationYaw, Index), AbsAngleDelta(Expected.RotationRoll, Actual.RotationRoll, Index)));
+			VectorStore(RotationError, OutRotationErrors.GetData() + Index);
+		}
+	}
+
+	void FPoseComparisonReport::AddFrame(const FPoseSoA& Expected, const FPoseSoA& Actual)
+	{
+		check(Expected.NumBones == BoneNames.Num());
+		ComparePoses(Expected, Actual, PositionErrors, RotationErrors);
+
+		for (int32 BoneIndex = 0; BoneIndex < BoneNames.Num(); ++BoneIndex)
+		{
+			const float PositionError = PositionErrors[BoneIndex];
+			const float RotationError = RotationErrors[BoneIndex];
+
+			FBoneErrorStats& Stats = BoneStats[BoneIndex];
+			Stats.MaxPositionError = FMath::Max(Stats.MaxPositionError, PositionError);
+			Stats.MaxRotationError = FMath::Max(Stats.MaxRotationError, RotationError);
+			Stats.SumSquaredPositionError += FMath::Square(PositionError);
+			Stats.SumSquaredRotationError += FMath::Square(RotationError);
+
+			// Same pass rule as FVector::Equals and FRotator::Equals, errors equal to the tolerance pass
+			if (PositionError > PositionTolerance || RotationError > RotationTolerance)
+			{
+				++Stats.NumMismatches;
+				++NumMismatches;
+				if (Mismatches.Num() < MaxStoredMismatches)
+				{
+					Mismatches.Add({NumFrames, BoneIndex, PositionError, RotationError});
+				}
+			}
+		}
+		++NumFrames;
+	}
+
+	FString FPoseComparisonReport::ToString(int32 MaxBones) const
+	{
+		FString Report = FString::Printf(TEXT("%d mismatches in %d frames of %d bones (position tolerance %.2f, rotation tolerance %.2f deg)"),
+			NumMismatches, NumFrames, BoneNames.Num(), PositionTolerance, RotationTolerance);
+		if (NumFrames == 0) return Report;
+
+		TArray<int32> BoneOrder;
+		for (int32 BoneIndex = 0; BoneIndex < BoneStats.Num(); ++BoneIndex)
+		{
+			if (BoneStats[BoneIndex].NumMismatches > 0)
+			{
+				BoneOrder.Add(BoneIndex);
+			}
+		}
+		BoneOrder.Sort([this](int32 A, int32 B)
+			{
+				return BoneStats[A].NumMismatches != BoneStats[B].NumMismatches
+					? BoneStats[A].NumMismatches > BoneStats[B].NumMismatches
+					: BoneStats[A].MaxPositionError > BoneStats[B].MaxPositionError;
+			});
+
+		for (int32 Rank = 0; Rank < FMath::Min(MaxBones, BoneOrder.Num()); ++Rank)
+		{
+			const FBoneErrorStats& Stats = BoneStats[BoneOrder[Rank]];
+			Report += FString::Printf(TEXT("\n  %s: %d mismatches, position max %.3f rms %.3f, rotation max %.3f rms %.3f deg"),
+				*BoneNames[BoneOrder[Rank]].ToString(), Stats.NumMismatches,
+				Stats.MaxPositionError, FMath::Sqrt(Stats.SumSquaredPositionError / NumFrames),
+				Stats.MaxRotationError, FMath::Sqrt(Stats.SumSquaredRotationError / NumFrames));
+		}
+		if (BoneOrder.Num() > MaxBones)
+		{
+			Report += FString::Printf(TEXT("\n  ... and %d more bones"), BoneOrder.Num() - MaxBones);
+		}
+		return Report;
+	}
+}
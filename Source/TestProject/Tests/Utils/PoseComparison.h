@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "TestProject/Tests/Utils/BoneRecordingUtils.h"
+#include "CoreMinimal.h"
+
+namespace TestProject
+{
+	/** Pose as structure of arrays, padded to whole SIMD registers so bones can be compared four at a time. */
+	struct FPoseSoA
+	{
+		static constexpr int32 Lanes = 4;
+
+		void SetNumBones(int32 InNumBones);
+		void SetBone(int32 BoneIndex, const FVector& Position, const FRotator& Rotation);
+		void SetBone(int32 BoneIndex, const FVector& Position, const FQuat& Rotation) { SetBone(BoneIndex, Position, Rotation.Rotator()); }
+
+		int32 NumBones{ 0 };
+		TArray<float> PositionX;
+		TArray<float> PositionY;
+		TArray<float> PositionZ;
+		// Rotator components in degrees, compared the same way as FRotator::Equals
+		TArray<float> RotationPitch;
+		TArray<float> RotationYaw;
+		TArray<float> RotationRoll;
+	};
+
+	/**
+	 * Samples a recorded animation at any time between its samples: positions are lerped, rotations slerped.
+	 * Lookups move a forward cursor, so sampling increasing times costs O(bones) per call.
+	 * Times outside the recording are clamped to its first or last sample.
+	 */
+	class FRecordedPoseCursor
+	{
+	public:
+		explicit FRecordedPoseCursor(const FRecordingAnimationData& AnimationData);
+
+		int32 GetNumBones() const { return BoneNames.Num(); }
+		FName GetBoneName(int32 BoneIndex) const { return BoneNames[BoneIndex]; }
+		const TArray<FName>& GetBoneNames() const { return BoneNames; }
+		float GetStartTime() const { return Times.Num() > 0 ? Times[0] : 0.0f; }
+		float GetEndTime() const { return Times.Num() > 0 ? Times.Last() : 0.0f; }
+		bool IsEmpty() const { return Times.IsEmpty(); }
+
+		void Sample(float Time, FPoseSoA& OutPose);
+
+	private:
+		TArray<FName> BoneNames;
+		TArray<float> Times;
+		// NumSamples x NumBones, converted once so sampling doesn't touch FRotator
+		TArray<FVector> Positions;
+		TArray<FQuat> Rotations;
+		int32 Cursor{ 0 };
+	};
+
+	struct FPoseMismatch
+	{
+		int32 Frame;
+		int32 BoneIndex;
+		// Largest per-axis position difference
+		float PositionError;
+		// Largest per-component rotator difference in degrees
+		float RotationError;
+	};
+
+	struct FBoneErrorStats
+	{
+		float MaxPositionError{ 0.0f };
+		float MaxRotationError{ 0.0f };
+		double SumSquaredPositionError{ 0.0 };
+		double SumSquaredRotationError{ 0.0 };
+		int32 NumMismatches{ 0 };
+	};
+
+	/**
+	 * Compares whole poses in batches and accumulates per-bone max/RMS errors.
+	 * Only a bounded list of mismatches is kept, the result is meant to be reported once when the comparison ends.
+	 */
+	class FPoseComparisonReport
+	{
+	public:
+		FPoseComparisonReport(const TArray<FName>& InBoneNames, float InPositionTolerance, float InRotationTolerance, int32 InMaxStoredMismatches = 256);
+
+		/**
+		 * Largest per-axis position difference and largest normalized per-component rotator difference of every bone,
+		 * so a bone mismatches exactly when FVector::Equals or FRotator::Equals with the same tolerance would fail.
+		 * Output arrays are resized to the padded bone count.
+		 */
+		static void ComparePoses(const FPoseSoA& Expected, const FPoseSoA& Actual, TArray<float>& OutPositionErrors, TArray<float>& OutRotationErrors);
+
+		void AddFrame(const FPoseSoA& Expected, const FPoseSoA& Actual);
+
+		int32 GetNumFrames() const { return NumFrames; }
+		int32 GetNumMismatches() const { return NumMismatches; }
+		const TArray<FPoseMismatch>& GetMismatches() const { return Mismatches; }
+		const TArray<FBoneErrorStats>& GetBoneStats() const { return BoneStats; }
+
+		/** Summary line followed by the worst bones, at most MaxBones of them. */
+		FString ToString(int32 MaxBones = 10) const;
+
+	private:
+		TArray<FName> BoneNames;
+		float PositionTolerance;
+		float RotationTolerance;
+		int32 MaxStoredMismatches;
+
+		TArray<FBoneErrorStats> BoneStats;
+		TArray<FPoseMismatch> Mismatches;
+		TArray<float> PositionErrors;
+		TArray<float> RotationErrors;
+		int32 NumFrames{ 0 };
+		int32 NumMismatches{ 0 };
+	};
+}
@@ -0,0 +1,416 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/PoseCompression.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPoseCompression, All, All);
+
+namespace TestProject
+{
+	namespace
+	{
+		constexpr uint32 CompressedMagic = 0x5A505054; // "TPPZ"
+		constexpr uint16 CompressedVersion = 2;
+
+		// Rotation header byte: index of the dropped component in the low bits, absolute flag above
+		constexpr uint8 RotationAbsoluteFlag = 0x4;
+		constexpr uint8 RotationIndexMask = 0x3;
+
+		struct FQuantizedBone
+		{
+			int64 Position[3];
+			int32 Rotation[3];
+			uint8 LargestIndex;
+
+			bool operator==(const FQuantizedBone& Other) const
+			{
+				return LargestIndex == Other.LargestIndex
+					&& Position[0] == Other.Position[0] && Position[1] == Other.Position[1] && Position[2] == Other.Position[2]
+					&& Rotation[0] == Other.Rotation[0] && Rotation[1] == Other.Rotation[1] && Rotation[2] == Other.Rotation[2];
+			}
+		};
+
+		double GetPositionStep(const FPoseCompressionSettings& Settings)
+		{
+			return 2.0 * Settings.PositionTolerance;
+		}
+
+		int32 GetRotationMax(const FPoseCompressionSettings& Settings)
+		{
+			return (1 << Settings.RotationBits) - 1;
+		}
+
+		uint64 ZigZag(int64 Value)
+		{
+			return (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63);
+		}
+
+		int64 UnZigZag(uint64 Value)
+		{
+			return static_cast<int64>(Value >> 1) ^ -static_cast<int64>(Value & 1);
+		}
+
+		void WriteVarInt(TArray<uint8>& Stream, uint64 Value)
+		{
+			while (Value >= 0x80)
+			{
+				Stream.Add(static_cast<uint8>(Value | 0x80));
+				Value >>= 7;
+			}
+			Stream.Add(static_cast<uint8>(Value));
+		}
+
+		class FStreamReader
+		{
+		public:
+			FStreamReader(const TArray<uint8>& InStream) : Stream(InStream) {}
+
+			bool ReadByte(uint8& OutValue)
+			{
+				if (Offset >= Stream.Num()) return false;
+				OutValue = Stream[Offset++];
+				return true;
+			}
+
+			bool ReadVarInt(uint64& OutValue)
+			{
+				OutValue = 0;
+				for (int32 Shift = 0; Shift < 64; Shift += 7)
+				{
+					uint8 Byte;
+					if (!ReadByte(Byte)) return false;
+					OutValue |= static_cast<uint64>(Byte & 0x7F) << Shift;
+					if ((Byte & 0x80) == 0) return true;
+				}
+				return false;
+			}
+
+			bool ReadSignedVarInt(int64& OutValue)
+			{
+				uint64 Value;
+				if (!ReadVarInt(Value)) return false;
+				OutValue = UnZigZag(Value);
+				return true;
+			}
+
+			bool IsAtEnd() const { return Offset == Stream.Num(); }
+
+		private:
+			const TArray<uint8>& Stream;
+			int32 Offset{ 0 };
+		};
+
+		FQuantizedBone Quantize(const FRecordingBoneData& BoneData, const FPoseCompressionSettings& Settings)
+		{
+			FQuantizedBone Bone;
+
+			const double Step = GetPositionStep(Settings);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Bone.Position[Axis] = FMath::RoundToInt64(BoneData.Position[Axis] / Step);
+			}
+
+			// Smallest three: drop the largest component and make it positive, the rest fit in [-1/sqrt(2), 1/sqrt(2)]
+			const FQuat Rotation = BoneData.Rotation.Quaternion();
+			const double Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+
+			uint8 LargestIndex = 0;
+			for (uint8 Index = 1; Index < 4; ++Index)
+			{
+				if (FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]))
+				{
+					LargestIndex = Index;
+				}
+			}
+			const double Sign = Components[LargestIndex] < 0.0 ? -1.0 : 1.0;
+
+			const int32 RotationMax = GetRotationMax(Settings);
+			int32 Out = 0;
+			for (uint8 Index = 0; Index < 4; ++Index)
+			{
+				if (Index == LargestIndex) continue;
+
+				const double Normalized = (Sign * Components[Index] + UE_HALF_SQRT_2) / UE_SQRT_2;
+				Bone.Rotation[Out++] = FMath::Clamp(static_cast<int32>(FMath::RoundToInt64(Normalized * RotationMax)), 0, RotationMax);
+			}
+			Bone.LargestIndex = LargestIndex;
+
+			return Bone;
+		}
+
+		FRecordingBoneData Dequantize(const FQuantizedBone& Bone, const FPoseCompressionSettings& Settings)
+		{
+			FRecordingBoneData BoneData;
+
+			const double Step = GetPositionStep(Settings);
+			BoneData.Position = FVector(Bone.Position[0] * Step, Bone.Position[1] * Step, Bone.Position[2] * Step);
+
+			const int32 RotationMax = GetRotationMax(Settings);
+			double Components[4];
+			double SquaredSum = 0.0;
+			int32 In = 0;
+			for (uint8 Index = 0; Index < 4; ++Index)
+			{
+				if (Index == Bone.LargestIndex) continue;
+
+				Components[Index] = static_cast<double>(Bone.Rotation[In++]) / RotationMax * UE_SQRT_2 - UE_HALF_SQRT_2;
+				SquaredSum += FMath::Square(Components[Index]);
+			}
+			Components[Bone.LargestIndex] = FMath::Sqrt(FMath::Max(0.0, 1.0 - SquaredSum));
+
+			BoneData.Rotation = FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized().Rotator();
+			return BoneData;
+		}
+
+		void WriteBone(TArray<uint8>& Stream, const FQuantizedBone& Bone, const FQuantizedBone* Previous)
+		{
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				WriteVarInt(Stream, ZigZag(Bone.Position[Axis] - (Previous ? Previous->Position[Axis] : 0)));
+			}
+
+			// The dropped component can flip between samples, such rotations are stored in full
+			const bool bAbsolute = !Previous || Previous->LargestIndex != Bone.LargestIndex;
+			Stream.Add(Bone.LargestIndex | (bAbsolute ? RotationAbsoluteFlag : 0));
+			for (int32 Component = 0; Component < 3; ++Component)
+			{
+				WriteVarInt(Stream, ZigZag(Bone.Rotation[Component] - (bAbsolute ? 0 : Previous->Rotation[Component])));
+			}
+		}
+
+		bool ReadBone(FStreamReader& Reader, FQuantizedBone& InOutBone, bool bKeyframe)
+		{
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				int64 Delta;
+				if (!Reader.ReadSignedVarInt(Delta)) return false;
+				InOutBone.Position[Axis] = (bKeyframe ? 0 : InOutBone.Position[Axis]) + Delta;
+			}
+
+			uint8 RotationHeader;
+			if (!Reader.ReadByte(RotationHeader)) return false;
+
+			const bool bAbsolute = (RotationHeader & RotationAbsoluteFlag) != 0;
+			if (bKeyframe && !bAbsolute) return false;
+
+			InOutBone.LargestIndex = RotationHeader & RotationIndexMask;
+			for (int32 Component = 0; Component < 3; ++Component)
+			{
+				int64 Delta;
+				if (!Reader.ReadSignedVarInt(Delta)) return false;
+				InOutBone.Rotation[Component] = static_cast<int32>((bAbsolute ? 0 : InOutBone.Rotation[Component]) + Delta);
+			}
+			return true;
+		}
+	}
+
+	double FPoseCompressionSettings::GetMaxPositionError() const
+	{
+		// Half a grid step plus the rounding of the multiplication on decompression
+		return PositionTolerance + UE_DOUBLE_SMALL_NUMBER;
+	}
+
+	double FPoseCompressionSettings::GetMaxRotationError() const
+	{
+		// Each stored component is off by at most half a step, the restored largest component by at most three
+		// times that, which bounds |q - q'| by sqrt(12) * E. The angle is 4 * asin(|q - q'| / 2), doubled for margin.
+		const double ComponentError = UE_HALF_SQRT_2 / ((1 << RotationBits) - 1);
+		const double ChordHalf = FMath::Min(1.0, FMath::Sqrt(12.0) * ComponentError);
+		return FMath::RadiansToDegrees(4.0 * FMath::Asin(ChordHalf));
+	}
+
+	double FPoseCompressionSettings::GetMaxRotatorError(double Pitch) const
+	{
+		// For yaw-pitch-roll angles and an angular velocity w, |pitch'| <= |w|, |yaw'| <= |w| / cos(pitch) and
+		// |roll'| <= |w| * (1 + |tan(pitch)|). Along the shortest arc of length A to the restored rotation the pitch
+		// stays within |Pitch| + A, integrating the largest rate over the arc bounds every component.
+		const double Angle = GetMaxRotationError();
+		const double WorstPitch = FMath::Abs(Pitch) + Angle;
+		if (WorstPitch >= 90.0) return TNumericLimits<double>::Max();
+
+		return Angle * (1.0 + FMath::Tan(FMath::DegreesToRadians(WorstPitch)));
+	}
+
+	bool FPoseCompressionSettings::IsValid() const
+	{
+		// RotationBits above 30 would shift past int32 in GetRotationMax
+		return PositionTolerance > 0.0 && RotationBits >= 2 && RotationBits <= 30 && KeyframeInterval >= 1;
+	}
+
+	FArchive& operator<<(FArchive& Ar, FCompressedAnimationData& Data)
+	{
+		Ar << Data.Settings.PositionTolerance;
+		Ar << Data.Settings.RotationBits;
+		Ar << Data.Settings.KeyframeInterval;
+		Ar << Data.InitialTransform;
+		Ar << Data.BoneNames;
+		Ar << Data.WorldTimes;
+		Ar << Data.Stream;
+		return Ar;
+	}
+
+	bool PoseCompression::Compress(const FRecordingAnimationData& AnimationData, const FPoseCompressionSettings& Settings, FCompressedAnimationData& OutData)
+	{
+		if (!Settings.IsValid())
+		{
+			UE_LOG(LogPoseCompression, Error, TEXT("Invalid pose compression settings"));
+			return false;
+		}
+
+		OutData = FCompressedAnimationData{};
+		OutData.Settings = Settings;
+		OutData.InitialTransform = AnimationData.InitialTransform;
+		if (AnimationData.SkeletonRecordings.IsEmpty()) return true;
+
+		const TArray<FRecordingBoneData>& FirstBones = AnimationData.SkeletonRecordings[0].BoneValues;
+		const int32 NumBones = FirstBones.Num();
+		for (const FRecordingBoneData& BoneData : FirstBones)
+		{
+			OutData.BoneNames.Add(BoneData.Name.ToString());
+		}
+
+		TArray<FQuantizedBone> Previous;
+		TArray<FQuantizedBone> Current;
+		Previous.SetNumZeroed(NumBones);
+		Current.SetNumZeroed(NumBones);
+
+		for (int32 FrameIndex = 0; FrameIndex < AnimationData.SkeletonRecordings.Num(); ++FrameIndex)
+		{
+			const FRecordingSkeletonData& SkeletonData = AnimationData.SkeletonRecordings[FrameIndex];
+			if (SkeletonData.BoneValues.Num() != NumBones)
+			{
+				UE_LOG(LogPoseCompression, Error, TEXT("Bone count changes at time %f"), SkeletonData.WorldTime);
+				return false;
+			}
+
+			OutData.WorldTimes.Add(SkeletonData.WorldTime);
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				Current[BoneIndex] = Quantize(SkeletonData.BoneValues[BoneIndex], Settings);
+			}
+
+			const bool bKeyframe = FrameIndex % Settings.KeyframeInterval == 0;
+			if (bKeyframe)
+			{
+				for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+				{
+					WriteBone(OutData.Stream, Current[BoneIndex], nullptr);
+				}
+			}
+			else
+			{
+				// One bit per bone, then only the bones that moved
+				const int32 MaskOffset = OutData.Stream.AddZeroed(FMath::DivideAndRoundUp(NumBones, 8));
+				for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+				{
+					if (Current[BoneIndex] == Previous[BoneIndex]) continue;
+
+					OutData.Stream[MaskOffset + BoneIndex / 8] |= 1 << (BoneIndex % 8);
+					WriteBone(OutData.Stream, Current[BoneIndex], &Previous[BoneIndex]);
+				}
+			}
+
+			Swap(Previous, Current);
+		}
+
+		return true;
+	}
+
+	bool PoseCompression::Decompress(const FCompressedAnimationData& Data, FRecordingAnimationData& OutAnimationData)
+	{
+		// Settings come from the file, a corrupt one must not reach the divisions and shifts below
+		if (!Data.Settings.IsValid())
+		{
+			UE_LOG(LogPoseCompression, Error, TEXT("Invalid pose compression settings"));
+			return false;
+		}
+
+		OutAnimationData.InitialTransform = Data.InitialTransform;
+		OutAnimationData.SkeletonRecordings.Reset(Data.WorldTimes.Num());
+
+		const int32 NumBones = Data.BoneNames.Num();
+		TArray<FName> BoneNames;
+		for (const FString& BoneName : Data.BoneNames)
+		{
+			BoneNames.Add(FName(*BoneName));
+		}
+
+		TArray<FQuantizedBone> Bones;
+		Bones.SetNumZeroed(NumBones);
+
+		FStreamReader Reader(Data.Stream);
+		for (int32 FrameIndex = 0; FrameIndex < Data.WorldTimes.Num(); ++FrameIndex)
+		{
+			const bool bKeyframe = FrameIndex % Data.Settings.KeyframeInterval == 0;
+			if (bKeyframe)
+			{
+				for (FQuantizedBone& Bone : Bones)
+				{
+					if (!ReadBone(Reader, Bone, true)) return false;
+				}
+			}
+			else
+			{
+				TArray<uint8, TInlineAllocator<64>> Mask;
+				const int32 MaskSize = FMath::DivideAndRoundUp(NumBones, 8);
+				Mask.SetNumUninitialized(MaskSize);
+				for (int32 MaskIndex = 0; MaskIndex < MaskSize; ++MaskIndex)
+				{
+					if (!Reader.ReadByte(Mask[MaskIndex])) return false;
+				}
+				for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+				{
+					if ((Mask[BoneIndex / 8] & (1 << (BoneIndex % 8))) == 0) continue;
+					if (!ReadBone(Reader, Bones[BoneIndex], false)) return false;
+				}
+			}
+
+			FRecordingSkeletonData& SkeletonData = OutAnimationData.SkeletonRecordings.AddDefaulted_GetRef();
+			SkeletonData.WorldTime = Data.WorldTimes[FrameIndex];
+			SkeletonData.BoneValues.Reserve(NumBones);
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				FRecordingBoneData& BoneData = SkeletonData.BoneValues.Add_GetRef(Dequantize(Bones[BoneIndex], Data.Settings));
+				BoneData.Name = BoneNames[BoneIndex];
+			}
+		}
+
+		return Reader.IsAtEnd();
+	}
+
+	bool PoseCompression::WriteCompressedData(const FString& FileName, const FCompressedAnimationData& Data)
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FileName));
+		if (!Ar) return false;
+
+		uint32 Magic = CompressedMagic;
+		uint16 Version = CompressedVersion;
+		*Ar << Magic << Version;
+		*Ar << const_cast<FCompressedAnimationData&>(Data);
+
+		return Ar->Close() && !Ar->IsError();
+	}
+
+	bool PoseCompression::ReadCompressedData(const FString& FileName, FCompressedAnimationData& Data)
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*FileName));
+		if (!Ar) return false;
+
+		uint32 Magic = 0;
+		uint16 Version = 0;
+		*Ar << Magic << Version;
+		if (Magic != CompressedMagic || Version != CompressedVersion) return false;
+
+		*Ar << Data;
+		if (!Ar->Close() || Ar->IsError()) return false;
+
+		if (!Data.Settings.IsValid())
+		{
+			UE_LOG(LogPoseCompression, Error, TEXT("Invalid pose compression settings in %s"), *FileName);
+			return false;
+		}
+		return true;
+	}
+}
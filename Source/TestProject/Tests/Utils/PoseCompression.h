@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "TestProject/Tests/Utils/BoneRecordingUtils.h"
+#include "CoreMinimal.h"
+
+namespace TestProject
+{
+	struct FPoseCompressionSettings
+	{
+		// Max per-axis position error in world units
+		double PositionTolerance{ 0.1 };
+
+		// Bits per smallest-three quaternion component
+		int32 RotationBits{ 12 };
+
+		// Every N-th sample is stored in full, the rest are deltas to the previous sample
+		int32 KeyframeInterval{ 30 };
+
+		/** Upper bound of the position error along any axis. */
+		double GetMaxPositionError() const;
+
+		/** Upper bound of the angle between the original and the restored rotation, in degrees. */
+		double GetMaxRotationError() const;
+
+		/**
+		 * Upper bound of the difference of any restored rotator component, as compared by FRotator::Equals, in degrees.
+		 * Depends on the original pitch: yaw and roll become ill-defined towards +-90 pitch, where no bound exists
+		 * and the largest double is returned.
+		 */
+		double GetMaxRotatorError(double Pitch) const;
+
+		bool IsValid() const;
+	};
+
+	/**
+	 * Quantized, delta-encoded FRecordingAnimationData.
+	 * Positions are snapped to a 2 * PositionTolerance grid, rotations are stored as smallest-three
+	 * quaternions. Keyframes hold absolute values, other samples hold zigzag varint deltas of the changed
+	 * bones only, so a bone that doesn't move costs a single bit.
+	 */
+	struct FCompressedAnimationData
+	{
+		FPoseCompressionSettings Settings;
+		FTransform InitialTransform;
+		TArray<FString> BoneNames;
+		TArray<float> WorldTimes;
+		TArray<uint8> Stream;
+
+		friend FArchive& operator<<(FArchive& Ar, FCompressedAnimationData& Data);
+	};
+
+	class PoseCompression
+	{
+	public:
+		static bool Compress(const FRecordingAnimationData& AnimationData, const FPoseCompressionSettings& Settings, FCompressedAnimationData& OutData);
+		static bool Decompress(const FCompressedAnimationData& Data, FRecordingAnimationData& OutAnimationData);
+
+		static bool WriteCompressedData(const FString& FileName, const FCompressedAnimationData& Data);
+		static bool ReadCompressedData(const FString& FileName, FCompressedAnimationData& Data);
+	};
+}
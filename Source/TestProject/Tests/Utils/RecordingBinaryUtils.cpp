@@ -0,0 +1,431 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/RecordingBinaryUtils.h"
+#include "Tests/Utils/JsonUtils.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRecordingBinary, All, All);
+
+namespace TestProject
+{
+	namespace
+	{
+		uint64 AlignTo8(uint64 Value)
+		{
+			return Align(Value, 8);
+		}
+
+		void WritePadding(FArchive& Ar, uint64 Written)
+		{
+			static const uint8 Zeros[8]{};
+			const uint64 Padding = AlignTo8(Written) - Written;
+			if (Padding > 0)
+			{
+				Ar.Serialize(const_cast<uint8*>(Zeros), Padding);
+			}
+		}
+
+		bool WriteRecording(const FString& FileName, ERecordingKind Kind, uint8 ComponentsPerSlot, const FTransform& InitialTransform,
+			const TArray<FName>& Names, const TArray<uint32>& SlotNameIndices, int32 NumFrames,
+			TFunctionRef<void(int32 FrameIndex, double* OutFrame)> FillFrame)
+		{
+			TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FileName));
+			if (!Ar) return false;
+
+			FRecordingFileHeader Header;
+			Header.Kind = Kind;
+			Header.ComponentsPerSlot = ComponentsPerSlot;
+			Header.NumFrames = NumFrames;
+			RecordingBinaryUtils::TransformToArray(InitialTransform, Header.InitialTransform);
+			if (!RecordingBinaryUtils::WriteHeaderAndTables(*Ar, Header, Names, SlotNameIndices)) return false;
+
+			TArray<double> Frame;
+			Frame.SetNumZeroed(Header.FrameStride / sizeof(double));
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+			{
+				FillFrame(FrameIndex, Frame.GetData());
+				Ar->Serialize(Frame.GetData(), Header.FrameStride);
+			}
+
+			return Ar->Close() && !Ar->IsError();
+		}
+	}
+
+	FMappedRecording::FMappedRecording() = default;
+
+	FMappedRecording::~FMappedRecording()
+	{
+		Close();
+	}
+
+	bool FMappedRecording::Open(const FString& FileName)
+	{
+		Close();
+
+		MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FileName));
+		if (MappedHandle)
+		{
+			MappedRegion.Reset(MappedHandle->MapRegion());
+		}
+
+		int64 Size = 0;
+		if (MappedRegion)
+		{
+			Data = MappedRegion->GetMappedPtr();
+			Size = MappedRegion->GetMappedSize();
+		}
+		else
+		{
+			if (!FFileHelper::LoadFileToArray(FallbackBuffer, *FileName)) return false;
+			Data = FallbackBuffer.GetData();
+			Size = FallbackBuffer.Num();
+		}
+
+		if (!Validate(Size))
+		{
+			UE_LOG(LogRecordingBinary, Error, TEXT("%s is not a valid recording file"), *FileName);
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void FMappedRecording::Close()
+	{
+		Header = nullptr;
+		Data = nullptr;
+		SlotNames.Reset();
+		MappedRegion.Reset();
+		MappedHandle.Reset();
+		FallbackBuffer.Empty();
+	}
+
+	FTransform FMappedRecording::GetInitialTransform() const
+	{
+		return RecordingBinaryUtils::ArrayToTransform(Header->InitialTransform);
+	}
+
+	bool FMappedRecording::Validate(int64 Size)
+	{
+		if (!Data || Size < static_cast<int64>(sizeof(FRecordingFileHeader))) return false;
+
+		const FRecordingFileHeader* FileHeader = reinterpret_cast<const FRecordingFileHeader*>(Data);
+		if (FileHeader->Magic != FRecordingFileHeader::MagicValue) return false;
+		if (FileHeader->Version != FRecordingFileHeader::CurrentVersion) return false;
+		if (FileHeader->FrameStride != sizeof(double) * (1 + static_cast<uint64>(FileHeader->NumSlots) * FileHeader->ComponentsPerSlot)) return false;
+
+		// Blocks follow each other inside the file. With the order checked, every size below is compared against the
+		// space left instead of adding offsets, so a crafted header can't wrap around and pass.
+		if (FileHeader->NameTableOffset < sizeof(FRecordingFileHeader)
+			|| FileHeader->NameTableOffset > FileHeader->SlotTableOffset
+			|| FileHeader->SlotTableOffset > FileHeader->FramesOffset
+			|| FileHeader->FramesOffset > static_cast<uint64>(Size)) return false;
+		if (FileHeader->SlotTableOffset % alignof(uint32) != 0 || FileHeader->FramesOffset % sizeof(double) != 0) return false;
+		// Every name takes at least its length prefix, checked before the name array is reserved
+		if (FileHeader->NumNames > (FileHeader->SlotTableOffset - FileHeader->NameTableOffset) / sizeof(uint32)) return false;
+		if (FileHeader->NumSlots > (FileHeader->FramesOffset - FileHeader->SlotTableOffset) / sizeof(uint32)) return false;
+		if (FileHeader->NumFrames > (static_cast<uint64>(Size) - FileHeader->FramesOffset) / FileHeader->FrameStride) return false;
+
+		TArray<FName> Names;
+		Names.Reserve(FileHeader->NumNames);
+		uint64 Offset = FileHeader->NameTableOffset;
+		for (uint32 NameIndex = 0; NameIndex < FileHeader->NumNames; ++NameIndex)
+		{
+			if (FileHeader->SlotTableOffset - Offset < sizeof(uint32)) return false;
+			uint32 Length;
+			FMemory::Memcpy(&Length, Data + Offset, sizeof(uint32));
+			Offset += sizeof(uint32);
+			if (Length > FileHeader->SlotTableOffset - Offset) return false;
+
+			const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data + Offset), Length);
+			Names.Emplace(Converter.Length(), Converter.Get());
+			Offset += Length;
+		}
+
+		const uint32* SlotNameIndices = reinterpret_cast<const uint32*>(Data + FileHeader->SlotTableOffset);
+		SlotNames.Reset(FileHeader->NumSlots);
+		for (uint32 SlotIndex = 0; SlotIndex < FileHeader->NumSlots; ++SlotIndex)
+		{
+			if (SlotNameIndices[SlotIndex] >= FileHeader->NumNames) return false;
+			SlotNames.Add(Names[SlotNameIndices[SlotIndex]]);
+		}
+
+		Header = FileHeader;
+		return true;
+	}
+
+	bool RecordingBinaryUtils::WriteInputData(const FString& FileName, const FInputData& InputData)
+	{
+		// Every action listed in the first frame is a slot, frames are expanded to the held value of every slot
+		TArray<FName> SlotNames;
+		if (InputData.Bindings.Num() > 0)
+		{
+			for (const FAxisData& AxisData : InputData.Bindings[0].AxisValues)
+			{
+				SlotNames.AddUnique(AxisData.Name);
+			}
+		}
+
+		TArray<FName> Names;
+		TArray<uint32> SlotNameIndices;
+		BuildSlotTable(SlotNames, Names, SlotNameIndices);
+
+		TArray<TArray<int32>> FrameSlots;
+		FrameSlots.SetNum(InputData.Bindings.Num());
+		for (int32 FrameIndex = 0; FrameIndex < InputData.Bindings.Num(); ++FrameIndex)
+		{
+			const FBindingsData& BindingsData = InputData.Bindings[FrameIndex];
+			for (const FAxisData& AxisData : BindingsData.AxisValues)
+			{
+				const int32 SlotIndex = SlotNames.IndexOfByKey(AxisData.Name);
+				if (SlotIndex == INDEX_NONE)
+				{
+					UE_LOG(LogRecordingBinary, Error, TEXT("%s isn't in the first frame, can't write %s"), *AxisData.Name.ToString(), *FileName);
+					return false;
+				}
+				FrameSlots[FrameIndex].Add(SlotIndex);
+			}
+		}
+
+		TArray<FVector2D> HeldValues;
+		HeldValues.Init(FVector2D::ZeroVector, SlotNames.Num());
+		return WriteRecording(FileName, ERecordingKind::Input, InputComponentsPerSlot, InputData.InitialTransform, Names, SlotNameIndices,
+			InputData.Bindings.Num(),
+			[&InputData, &FrameSlots, &HeldValues](int32 FrameIndex, double* OutFrame)
+			{
+				const FBindingsData& BindingsData = InputData.Bindings[FrameIndex];
+				for (int32 AxisIndex = 0; AxisIndex < BindingsData.AxisValues.Num(); ++AxisIndex)
+				{
+					HeldValues[FrameSlots[FrameIndex][AxisIndex]] = BindingsData.AxisValues[AxisIndex].Value;
+				}
+
+				*OutFrame++ = BindingsData.WorldTime;
+				for (const FVector2D& Value : HeldValues)
+				{
+					*OutFrame++ = Value.X;
+					*OutFrame++ = Value.Y;
+				}
+			});
+	}
+
+	bool RecordingBinaryUtils::ReadInputData(const FString& FileName, FInputData& InputData)
+	{
+		FMappedRecording Recording;
+		if (!Recording.Open(FileName)) return false;
+		if (Recording.GetKind() != ERecordingKind::Input || Recording.GetComponentsPerSlot() != InputComponentsPerSlot) return false;
+
+		InputData.InitialTransform = Recording.GetInitialTransform();
+		InputData.Bindings.Reset();
+
+		// Dense frames are reduced to transitions, see FInputData
+		const int32 NumFrames = Recording.GetNumFrames();
+		TConstArrayView<double> PreviousValues;
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			const TConstArrayView<double> Values = Recording.GetFrameValues(FrameIndex);
+
+			FBindingsData BindingsData;
+			BindingsData.WorldTime = Recording.GetFrameTime(FrameIndex);
+			for (int32 SlotIndex = 0; SlotIndex < Recording.GetNumSlots(); ++SlotIndex)
+			{
+				const int32 ValueIndex = SlotIndex * InputComponentsPerSlot;
+				if (FrameIndex > 0 && Values[ValueIndex] == PreviousValues[ValueIndex] && Values[ValueIndex + 1] == PreviousValues[ValueIndex + 1]) continue;
+
+				FAxisData& AxisData = BindingsData.AxisValues.AddDefaulted_GetRef();
+				AxisData.Name = Recording.GetSlotName(SlotIndex);
+				AxisData.Value = FVector2D(Values[ValueIndex], Values[ValueIndex + 1]);
+			}
+			PreviousValues = Values;
+
+			if (FrameIndex == 0 || FrameIndex == NumFrames - 1 || BindingsData.AxisValues.Num() > 0)
+			{
+				InputData.Bindings.Add(MoveTemp(BindingsData));
+			}
+		}
+		return true;
+	}
+
+	bool RecordingBinaryUtils::WriteSkeletonData(const FString& FileName, const FRecordingAnimationData& AnimationData)
+	{
+		TArray<FName> Names;
+		TArray<uint32> SlotNameIndices;
+		if (AnimationData.SkeletonRecordings.Num() > 0)
+		{
+			TArray<FName> FrameNames;
+			for (const FRecordingBoneData& BoneData : AnimationData.SkeletonRecordings[0].BoneValues)
+			{
+				FrameNames.Add(BoneData.Name);
+			}
+			BuildSlotTable(FrameNames, Names, SlotNameIndices);
+		}
+
+		for (const FRecordingSkeletonData& SkeletonData : AnimationData.SkeletonRecordings)
+		{
+			if (SkeletonData.BoneValues.Num() != SlotNameIndices.Num()) return false;
+			for (int32 SlotIndex = 0; SlotIndex < SlotNameIndices.Num(); ++SlotIndex)
+			{
+				if (SkeletonData.BoneValues[SlotIndex].Name != Names[SlotNameIndices[SlotIndex]])
+				{
+					UE_LOG(LogRecordingBinary, Error, TEXT("Bone layout changes at time %f, can't write %s"), SkeletonData.WorldTime, *FileName);
+					return false;
+				}
+			}
+		}
+
+		return WriteRecording(FileName, ERecordingKind::Animation, AnimationComponentsPerSlot, AnimationData.InitialTransform, Names, SlotNameIndices,
+			AnimationData.SkeletonRecordings.Num(),
+			[&AnimationData](int32 FrameIndex, double* OutFrame)
+			{
+				const FRecordingSkeletonData& SkeletonData = AnimationData.SkeletonRecordings[FrameIndex];
+				*OutFrame++ = SkeletonData.WorldTime;
+				for (const FRecordingBoneData& BoneData : SkeletonData.BoneValues)
+				{
+					*OutFrame++ = BoneData.Position.X;
+					*OutFrame++ = BoneData.Position.Y;
+					*OutFrame++ = BoneData.Position.Z;
+					*OutFrame++ = BoneData.Rotation.Pitch;
+					*OutFrame++ = BoneData.Rotation.Yaw;
+					*OutFrame++ = BoneData.Rotation.Roll;
+				}
+			});
+	}
+
+	bool RecordingBinaryUtils::ReadSkeletonData(const FString& FileName, FRecordingAnimationData& AnimationData)
+	{
+		FMappedRecording Recording;
+		if (!Recording.Open(FileName)) return false;
+		if (Recording.GetKind() != ERecordingKind::Animation || Recording.GetComponentsPerSlot() != AnimationComponentsPerSlot) return false;
+
+		AnimationData.InitialTransform = Recording.GetInitialTransform();
+		AnimationData.SkeletonRecordings.SetNum(Recording.GetNumFrames());
+		for (int32 FrameIndex = 0; FrameIndex < Recording.GetNumFrames(); ++FrameIndex)
+		{
+			FRecordingSkeletonData& SkeletonData = AnimationData.SkeletonRecordings[FrameIndex];
+			SkeletonData.WorldTime = Recording.GetFrameTime(FrameIndex);
+			SkeletonData.BoneValues.SetNum(Recording.GetNumSlots());
+
+			const double* Values = Recording.GetFrameValues(FrameIndex).GetData();
+			for (int32 SlotIndex = 0; SlotIndex < Recording.GetNumSlots(); ++SlotIndex, Values += AnimationComponentsPerSlot)
+			{
+				FRecordingBoneData& BoneData = SkeletonData.BoneValues[SlotIndex];
+				BoneData.Name = Recording.GetSlotName(SlotIndex);
+				BoneData.Position = FVector(Values[0], Values[1], Values[2]);
+				BoneData.Rotation = FRotator(Values[3], Values[4], Values[5]);
+			}
+		}
+		return true;
+	}
+
+	bool RecordingBinaryUtils::ConvertJsonToBinary(const FString& JsonFileName, const FString& BinaryFileName)
+	{
+		FString FileContentString;
+		if (!FFileHelper::LoadFileToString(FileContentString, *JsonFileName)) return false;
+
+		TSharedPtr<FJsonObject> MainJsonObject;
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(FileContentString);
+		if (!FJsonSerializer::Deserialize(JsonReader, MainJsonObject) || !MainJsonObject.IsValid()) return false;
+
+		if (MainJsonObject->HasField(TEXT("skeletonRecordings")))
+		{
+			FRecordingAnimationData AnimationData;
+			return JsonUtils::ReadSkeletonData(JsonFileName, AnimationData) && WriteSkeletonData(BinaryFileName, AnimationData);
+		}
+
+		FInputData InputData;
+		return JsonUtils::ReadInputData(JsonFileName, InputData) && WriteInputData(BinaryFileName, InputData);
+	}
+
+	bool RecordingBinaryUtils::ConvertBinaryToJson(const FString& BinaryFileName, const FString& JsonFileName)
+	{
+		FMappedRecording Recording;
+		if (!Recording.Open(BinaryFileName)) return false;
+
+		const ERecordingKind Kind = Recording.GetKind();
+		Recording.Close();
+
+		if (Kind == ERecordingKind::Animation)
+		{
+			FRecordingAnimationData AnimationData;
+			return ReadSkeletonData(BinaryFileName, AnimationData) && JsonUtils::WriteSkeletonData(JsonFileName, AnimationData);
+		}
+
+		FInputData InputData;
+		return ReadInputData(BinaryFileName, InputData) && JsonUtils::WriteInputData(JsonFileName, InputData);
+	}
+
+	bool RecordingBinaryUtils::IsBinaryRecording(const FString& FileName)
+	{
+		return FPaths::GetExtension(FileName).Equals(TEXT("tprec"), ESearchCase::IgnoreCase);
+	}
+
+	void RecordingBinaryUtils::BuildSlotTable(TConstArrayView<FName> FrameNames, TArray<FName>& OutNames, TArray<uint32>& OutSlotNameIndices)
+	{
+		OutSlotNameIndices.Reset(FrameNames.Num());
+		for (const FName& Name : FrameNames)
+		{
+			OutSlotNameIndices.Add(static_cast<uint32>(OutNames.AddUnique(Name)));
+		}
+	}
+
+	bool RecordingBinaryUtils::WriteHeaderAndTables(FArchive& Ar, FRecordingFileHeader& InOutHeader, const TArray<FName>& Names, const TArray<uint32>& SlotNameIndices)
+	{
+		TArray<TArray<UTF8CHAR>> Utf8Names;
+		Utf8Names.Reserve(Names.Num());
+		uint64 NameTableSize = 0;
+		for (const FName& Name : Names)
+		{
+			const FTCHARToUTF8 Converter(*Name.ToString());
+			Utf8Names.Emplace(reinterpret_cast<const UTF8CHAR*>(Converter.Get()), Converter.Length());
+			NameTableSize += sizeof(uint32) + Converter.Length();
+		}
+
+		InOutHeader.Magic = FRecordingFileHeader::MagicValue;
+		InOutHeader.Version = FRecordingFileHeader::CurrentVersion;
+		InOutHeader.NumNames = Names.Num();
+		InOutHeader.NumSlots = SlotNameIndices.Num();
+		InOutHeader.FrameStride = sizeof(double) * (1 + SlotNameIndices.Num() * InOutHeader.ComponentsPerSlot);
+		InOutHeader.NameTableOffset = sizeof(FRecordingFileHeader);
+		InOutHeader.SlotTableOffset = InOutHeader.NameTableOffset + AlignTo8(NameTableSize);
+		InOutHeader.FramesOffset = InOutHeader.SlotTableOffset + AlignTo8(SlotNameIndices.Num() * sizeof(uint32));
+
+		Ar.Serialize(&InOutHeader, sizeof(InOutHeader));
+
+		for (TArray<UTF8CHAR>& Utf8Name : Utf8Names)
+		{
+			uint32 Length = Utf8Name.Num();
+			Ar.Serialize(&Length, sizeof(Length));
+			Ar.Serialize(Utf8Name.GetData(), Length);
+		}
+		WritePadding(Ar, NameTableSize);
+
+		Ar.Serialize(const_cast<uint32*>(SlotNameIndices.GetData()), SlotNameIndices.Num() * sizeof(uint32));
+		WritePadding(Ar, SlotNameIndices.Num() * sizeof(uint32));
+
+		return !Ar.IsError();
+	}
+
+	void RecordingBinaryUtils::TransformToArray(const FTransform& Transform, double* Out)
+	{
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Translation = Transform.GetTranslation();
+		const FVector Scale = Transform.GetScale3D();
+
+		Out[0] = Rotation.X; Out[1] = Rotation.Y; Out[2] = Rotation.Z; Out[3] = Rotation.W;
+		Out[4] = Translation.X; Out[5] = Translation.Y; Out[6] = Translation.Z;
+		Out[7] = Scale.X; Out[8] = Scale.Y; Out[9] = Scale.Z;
+	}
+
+	FTransform RecordingBinaryUtils::ArrayToTransform(const double* In)
+	{
+		// Rotation is restored as is, FTransform's constructor doesn't normalize it
+		return FTransform(FQuat(In[0], In[1], In[2], In[3]), FVector(In[4], In[5], In[6]), FVector(In[7], In[8], In[9]));
+	}
+}
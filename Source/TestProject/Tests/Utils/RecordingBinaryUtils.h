@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "TestProject/Tests/Utils/InputRecordingUtils.h"
+#include "TestProject/Tests/Utils/BoneRecordingUtils.h"
+#include "CoreMinimal.h"
+
+class FArchive;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace TestProject
+{
+	/**
+	 * Binary recording container (*.tprec), little-endian:
+	 *   FRecordingFileHeader
+	 *   name table  : NumNames x { uint32 Utf8Length, Utf8 bytes }, padded to 8 bytes
+	 *   slot table  : NumSlots x uint32 name index, padded to 8 bytes
+	 *   frame block : NumFrames x FrameStride bytes, each frame is
+	 *                 double WorldTime + NumSlots * ComponentsPerSlot doubles
+	 * Input slots store Value.X/Y, animation slots store Position.XYZ and Rotation.Pitch/Yaw/Roll.
+	 */
+	enum class ERecordingKind : uint8
+	{
+		Input = 0,
+		Animation
+	};
+
+	constexpr uint8 InputComponentsPerSlot = 2;
+	constexpr uint8 AnimationComponentsPerSlot = 6;
+
+	struct FRecordingFileHeader
+	{
+		static constexpr uint32 MagicValue = 0x43525054; // "TPRC"
+		static constexpr uint16 CurrentVersion = 1;
+
+		uint32 Magic{ MagicValue };
+		uint16 Version{ CurrentVersion };
+		ERecordingKind Kind{ ERecordingKind::Input };
+		uint8 ComponentsPerSlot{ 0 };
+		uint32 NumNames{ 0 };
+		uint32 NumSlots{ 0 };
+		uint32 NumFrames{ 0 };
+		uint32 FrameStride{ 0 };
+		uint64 NameTableOffset{ 0 };
+		uint64 SlotTableOffset{ 0 };
+		uint64 FramesOffset{ 0 };
+		// Rotation XYZW, Translation XYZ, Scale3D XYZ
+		double InitialTransform[10]{};
+	};
+	static_assert(sizeof(FRecordingFileHeader) == 128, "Recording header layout changed, bump CurrentVersion");
+
+	/** Read-only view over a memory mapped *.tprec file. Frames are accessed in place, nothing is copied per field. */
+	class FMappedRecording
+	{
+	public:
+		FMappedRecording();
+		~FMappedRecording();
+
+		bool Open(const FString& FileName);
+		void Close();
+
+		bool IsValid() const { return Header != nullptr; }
+		ERecordingKind GetKind() const { return Header->Kind; }
+		int32 GetNumFrames() const { return static_cast<int32>(Header->NumFrames); }
+		int32 GetNumSlots() const { return static_cast<int32>(Header->NumSlots); }
+		int32 GetComponentsPerSlot() const { return Header->ComponentsPerSlot; }
+		FName GetSlotName(int32 SlotIndex) const { return SlotNames[SlotIndex]; }
+		FTransform GetInitialTransform() const;
+
+		float GetFrameTime(int32 FrameIndex) const { return static_cast<float>(GetFrame(FrameIndex)[0]); }
+		/** Slot values of a frame, NumSlots * ComponentsPerSlot doubles. */
+		TConstArrayView<double> GetFrameValues(int32 FrameIndex) const
+		{
+			return TConstArrayView<double>(GetFrame(FrameIndex) + 1, GetNumSlots() * GetComponentsPerSlot());
+		}
+
+	private:
+		const double* GetFrame(int32 FrameIndex) const
+		{
+			return reinterpret_cast<const double*>(Data + Header->FramesOffset + static_cast<uint64>(FrameIndex) * Header->FrameStride);
+		}
+		bool Validate(int64 Size);
+
+		TUniquePtr<IMappedFileHandle> MappedHandle;
+		TUniquePtr<IMappedFileRegion> MappedRegion;
+		// Used when the platform file can't be mapped (e.g. inside a pak)
+		TArray64<uint8> FallbackBuffer;
+
+		const uint8* Data{ nullptr };
+		const FRecordingFileHeader* Header{ nullptr };
+		TArray<FName> SlotNames;
+	};
+
+	class RecordingBinaryUtils
+	{
+	public:
+		static bool WriteInputData(const FString& FileName, const FInputData& InputData);
+		static bool ReadInputData(const FString& FileName, FInputData& InputData);
+		static bool WriteSkeletonData(const FString& FileName, const FRecordingAnimationData& AnimationData);
+		static bool ReadSkeletonData(const FString& FileName, FRecordingAnimationData& AnimationData);
+
+		/** Lossless migration between the JSON recordings and *.tprec, the kind is taken from the JSON content. */
+		static bool ConvertJsonToBinary(const FString& JsonFileName, const FString& BinaryFileName);
+		static bool ConvertBinaryToJson(const FString& BinaryFileName, const FString& JsonFileName);
+
+		static bool IsBinaryRecording(const FString& FileName);
+
+		/** Interns the names of one frame into a name table and a per-slot index list. */
+		static void BuildSlotTable(TConstArrayView<FName> FrameNames, TArray<FName>& OutNames, TArray<uint32>& OutSlotNameIndices);
+
+		/**
+		 * Writes the header, name and slot tables, leaving the archive at the start of the frame block.
+		 * Kind, ComponentsPerSlot, NumFrames and InitialTransform are taken from InOutHeader, the rest is filled in.
+		 */
+		static bool WriteHeaderAndTables(FArchive& Ar, FRecordingFileHeader& InOutHeader, const TArray<FName>& Names, const TArray<uint32>& SlotNameIndices);
+
+		static void TransformToArray(const FTransform& Transform, double* Out);
+		static FTransform ArrayToTransform(const double* In);
+	};
+}
@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/Utils/RecordingStreamWriter.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRecordingStreamWriter, All, All);
+
+namespace TestProject
+{
+	namespace
+	{
+		constexpr uint32 WriterWaitTimeMs = 100;
+	}
+
+	FRecordingStreamWriter::~FRecordingStreamWriter()
+	{
+		Finalize();
+	}
+
+	bool FRecordingStreamWriter::Open(const FString& InFileName, ERecordingKind Kind, uint8 ComponentsPerSlot, TConstArrayView<FName> SlotNames,
+		const FTransform& InitialTransform, int32 CapacityInFrames, FRecordEncoder InEncoder)
+	{
+		check(!IsOpen());
+		check(CapacityInFrames > 0);
+
+		FileName = InFileName;
+		Archive.Reset(IFileManager::Get().CreateFileWriter(*FileName));
+		if (!Archive)
+		{
+			UE_LOG(LogRecordingStreamWriter, Error, TEXT("Can't open %s for writing"), *FileName);
+			return false;
+		}
+
+		TArray<FName> Names;
+		TArray<uint32> SlotNameIndices;
+		RecordingBinaryUtils::BuildSlotTable(SlotNames, Names, SlotNameIndices);
+
+		Header = FRecordingFileHeader{};
+		Header.Kind = Kind;
+		Header.ComponentsPerSlot = ComponentsPerSlot;
+		RecordingBinaryUtils::TransformToArray(InitialTransform, Header.InitialTransform);
+		if (!RecordingBinaryUtils::WriteHeaderAndTables(*Archive, Header, Names, SlotNameIndices))
+		{
+			Archive.Reset();
+			return false;
+		}
+
+		Encoder = MoveTemp(InEncoder);
+		RecordSize = Encoder.Encode ? Align(Encoder.RecordSize, 16) : static_cast<int32>(Header.FrameStride);
+		Capacity = CapacityInFrames;
+		FlushThreshold = FMath::Max(1, Capacity / 4);
+		Ring.SetNumZeroed(Capacity * RecordSize);
+		EncodedFrames.SetNumZeroed(Encoder.Encode ? FlushThreshold * GetFrameSize() : 0);
+		Produced = 0;
+		Consumed = 0;
+		bStopRequested = false;
+
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		Thread = FRunnableThread::Create(this, TEXT("RecordingStreamWriter"), 0, TPri_BelowNormal);
+		if (!Thread)
+		{
+			// Finalize only cleans up after a running thread, so nothing else would release these
+			UE_LOG(LogRecordingStreamWriter, Error, TEXT("Can't start the writer thread for %s"), *FileName);
+			FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+			WorkEvent = nullptr;
+			Archive.Reset();
+			Ring.Empty();
+			EncodedFrames.Empty();
+			Encoder = {};
+			return false;
+		}
+		return true;
+	}
+
+	bool FRecordingStreamWriter::Finalize()
+	{
+		if (!Thread) return false;
+
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+
+		Header.NumFrames = static_cast<uint32>(Consumed.load());
+		Archive->Seek(0);
+		Archive->Serialize(&Header, sizeof(Header));
+		const bool bSuccess = Archive->Close() && !Archive->IsError();
+		Archive.Reset();
+
+		Ring.Empty();
+		EncodedFrames.Empty();
+		Encoder = {};
+		UE_LOG(LogRecordingStreamWriter, Display, TEXT("%s finalized with %u frames"), *FileName, Header.NumFrames);
+		return bSuccess;
+	}
+
+	uint8* FRecordingStreamWriter::AcquireRecord()
+	{
+		const uint64 Head = Produced.load(std::memory_order_relaxed);
+		if (Head - Consumed.load(std::memory_order_acquire) >= static_cast<uint64>(Capacity))
+		{
+			UE_LOG(LogRecordingStreamWriter, Warning, TEXT("Writer for %s fell behind, consider a bigger buffer"), *FileName);
+			WorkEvent->Trigger();
+			while (Head - Consumed.load(std::memory_order_acquire) >= static_cast<uint64>(Capacity))
+			{
+				FPlatformProcess::Yield();
+			}
+		}
+		return Ring.GetData() + (Head % Capacity) * RecordSize;
+	}
+
+	void FRecordingStreamWriter::CommitRecord()
+	{
+		const uint64 Head = Produced.load(std::memory_order_relaxed) + 1;
+		Produced.store(Head, std::memory_order_release);
+
+		if (Head - Consumed.load(std::memory_order_relaxed) >= static_cast<uint64>(FlushThreshold))
+		{
+			WorkEvent->Trigger();
+		}
+	}
+
+	uint32 FRecordingStreamWriter::Run()
+	{
+		while (!bStopRequested.load())
+		{
+			WorkEvent->Wait(WriterWaitTimeMs);
+			WriteAvailableFrames();
+		}
+		WriteAvailableFrames();
+		return 0;
+	}
+
+	void FRecordingStreamWriter::Stop()
+	{
+		bStopRequested = true;
+		if (WorkEvent)
+		{
+			WorkEvent->Trigger();
+		}
+	}
+
+	void FRecordingStreamWriter::WriteAvailableFrames()
+	{
+		uint64 Tail = Consumed.load(std::memory_order_relaxed);
+		const uint64 Head = Produced.load(std::memory_order_acquire);
+
+		while (Tail < Head)
+		{
+			// Write the contiguous part up to the end of the ring, the wrapped part goes in the next pass
+			const int32 Index = static_cast<int32>(Tail % Capacity);
+			int32 Count = static_cast<int32>(FMath::Min<uint64>(Head - Tail, Capacity - Index));
+			const uint8* Records = Ring.GetData() + Index * RecordSize;
+
+			if (Encoder.Encode)
+			{
+				Count = FMath::Min(Count, FlushThreshold);
+				for (int32 RecordIndex = 0; RecordIndex < Count; ++RecordIndex)
+				{
+					Encoder.Encode(Records + RecordIndex * RecordSize, EncodedFrames.GetData() + RecordIndex * GetFrameSize());
+				}
+				Archive->Serialize(EncodedFrames.GetData(), static_cast<int64>(Count) * Header.FrameStride);
+			}
+			else
+			{
+				Archive->Serialize(const_cast<uint8*>(Records), static_cast<int64>(Count) * Header.FrameStride);
+			}
+
+			Tail += Count;
+			Consumed.store(Tail, std::memory_order_release);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "TestProject/Tests/Utils/RecordingBinaryUtils.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+namespace TestProject
+{
+	/**
+	 * Turns a raw record captured on the game thread into a *.tprec frame on the writer thread.
+	 * Without an encoder records are frames and are written as is.
+	 */
+	struct FRecordEncoder
+	{
+		int32 RecordSize{ 0 };
+		TFunction<void(const uint8* Record, double* OutFrame)> Encode;
+	};
+
+	/**
+	 * Appends *.tprec frames to disk from a background thread.
+	 * The game thread fills records in a bounded single-producer ring buffer, the writer thread
+	 * drains it in chunks, so memory stays flat no matter how long the recording runs.
+	 * Finalize() flushes the remaining frames and patches the frame count in the header.
+	 */
+	class FRecordingStreamWriter : public FRunnable
+	{
+	public:
+		FRecordingStreamWriter() = default;
+		virtual ~FRecordingStreamWriter() override;
+
+		bool Open(const FString& FileName, ERecordingKind Kind, uint8 ComponentsPerSlot, TConstArrayView<FName> SlotNames,
+			const FTransform& InitialTransform, int32 CapacityInFrames, FRecordEncoder InEncoder = {});
+		bool Finalize();
+
+		bool IsOpen() const { return Thread != nullptr; }
+		int32 GetFrameSize() const { return Header.FrameStride / sizeof(double); }
+
+		/**
+		 * Returns a record to fill, blocks only if the writer fell a whole buffer behind.
+		 * Without an encoder the record is a frame: WorldTime followed by the slot values.
+		 */
+		uint8* AcquireRecord();
+		void CommitRecord();
+
+		double* AcquireFrame() { return reinterpret_cast<double*>(AcquireRecord()); }
+
+	protected:
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+
+	private:
+		void WriteAvailableFrames();
+
+		TUniquePtr<FArchive> Archive;
+		FRecordingFileHeader Header;
+		FString FileName;
+
+		FRecordEncoder Encoder;
+		TArray<double> EncodedFrames;
+
+		TArray<uint8> Ring;
+		int32 RecordSize{ 0 };
+		int32 Capacity{ 0 };
+		int32 FlushThreshold{ 0 };
+		std::atomic<uint64> Produced{ 0 };
+		std::atomic<uint64> Consumed{ 0 };
+		std::atomic<bool> bStopRequested{ false };
+
+		FRunnableThread* Thread{ nullptr };
+		FEvent* WorkEvent{ nullptr };
+	};
+}